@@ -1,152 +1,132 @@
 #include "Interval.h"
 #include "Check.h"
+#include "ContextPool.h"
+#include "HalideType.h"
+#include "Registry.h"
+#include "Report.h"
+
+namespace {
 
 
 void test_mod_unsigned_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test <any> % bounded unsigned Mod" << std::endl;
-    z3::context context;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test <any> % bounded unsigned Mod" << std::endl;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    // need to write this manually to use bit vectors (unsigned)
-    z3::expr a0 = context.bv_const("a0", 32);
-    z3::expr a1 = context.bv_const("a1", 32);
-    solver.add(z3::uge(a1, a0));
-
-    z3::expr b0 = context.bv_const("b0", 32);
-    z3::expr b1 = context.bv_const("b1", 32);
-    solver.add(z3::uge(b1, b0));
+    const HalideType type = HalideType::UInt(32);
+    z3::expr a0 = type.Variable(context, "a0");
+    z3::expr a1 = type.Variable(context, "a1");
+    solver.add(type.LessEqual(a0, a1));
+
+    z3::expr b0 = type.Variable(context, "b0");
+    z3::expr b1 = type.Variable(context, "b1");
+    solver.add(type.LessEqual(b0, b1));
     
-    z3::expr emin = context.bv_val(0, 32);
-    z3::expr emax = max(emin, b1 - 1);
-
-    z3::expr i = context.bv_const("i", 32);
-    z3::expr j = context.bv_const("j", 32);
-
-    // fully bounded
-    solver.add(z3::uge(a0, i)); // a0 <= i
-    solver.add(z3::uge(i, a1)); // i <= a1
-    solver.add(z3::uge(b0, j)); // b0 <= j
-    solver.add(z3::uge(j, b1)); // j <= b1
+    z3::expr emin = type.Value(context, 0);
+    z3::expr emax = type.Max(emin, b1 - 1);
+
+    z3::expr i = type.Variable(context, "i");
+    z3::expr j = type.Variable(context, "j");
+
+    // fully bounded, the bounds reversed as in the original report, which
+    // pins i to a0 == a1 and j to b0 == b1
+    solver.add(type.LessEqual(i, a0));
+    solver.add(type.LessEqual(a1, i));
+    solver.add(type.LessEqual(j, b0));
+    solver.add(type.LessEqual(b1, j));
     solver.add(b0 == b1 && b1 == 0);
 
-    z3::expr res = ite(j != 0, z3::urem(i, j), context.bv_val(0, 32)); // unsigned remainder
+    z3::expr res = ite(j != 0, z3::urem(i, j), type.Value(context, 0)); // unsigned remainder
 
     // we just care about the upper bound tightness
     solver.add(res == emax);
 
-    z3::check_result ans = solver.check();
+    report_tightness(solve(solver));
 
-    if (ans == z3::unsat) {
-        std::cout << " NOT tight." << std::endl;
-    } else if (ans == z3::unknown) {
-        std::cout << " Unknown." << std::endl;
-    } else {
-        std::cout << " Tight." << std::endl;
-    }
-
-    std::cout << "-------------------" << std::endl;
+    rule_output() << "-------------------" << std::endl;
 }
 
 
 void test_mod_unsigned_bounded_fix_zero() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test <any> % bounded unsigned 0 Mod fix" << std::endl;
-    z3::context context;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test <any> % bounded unsigned 0 Mod fix" << std::endl;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    // need to write this manually to use bit vectors (unsigned)
-    z3::expr a0 = context.bv_const("a0", 32);
-    z3::expr a1 = context.bv_const("a1", 32);
-    solver.add(z3::uge(a1, a0));
-
-    z3::expr b0 = context.bv_const("b0", 32);
-    z3::expr b1 = context.bv_const("b1", 32);
-    solver.add(z3::uge(b1, b0));
-    
-    z3::expr emin = context.bv_val(0, 32);
-    z3::expr emax = ite(b1 == 0, context.bv_val(0, 32), b1 - 1);
+    const HalideType type = HalideType::UInt(32);
+    z3::expr a0 = type.Variable(context, "a0");
+    z3::expr a1 = type.Variable(context, "a1");
+    solver.add(type.LessEqual(a0, a1));
+
+    z3::expr b0 = type.Variable(context, "b0");
+    z3::expr b1 = type.Variable(context, "b1");
+    solver.add(type.LessEqual(b0, b1));
     
-    max(emin, b1 - 1);
-
-    z3::expr i = context.bv_const("i", 32);
-    z3::expr j = context.bv_const("j", 32);
-
-    // fully bounded
-    solver.add(z3::uge(a0, i)); // a0 <= i
-    solver.add(z3::uge(i, a1)); // i <= a1
-    solver.add(z3::uge(b0, j)); // b0 <= j
-    solver.add(z3::uge(j, b1)); // j <= b1
+    z3::expr emin = type.Value(context, 0);
+    z3::expr emax = ite(b1 == 0, type.Value(context, 0), b1 - 1);
+
+    z3::expr i = type.Variable(context, "i");
+    z3::expr j = type.Variable(context, "j");
+
+    // fully bounded, the bounds reversed as in the original report, which
+    // pins i to a0 == a1 and j to b0 == b1
+    solver.add(type.LessEqual(i, a0));
+    solver.add(type.LessEqual(a1, i));
+    solver.add(type.LessEqual(j, b0));
+    solver.add(type.LessEqual(b1, j));
     solver.add(b0 == b1 && b1 == 0);
 
-    z3::expr res = ite(j != 0, z3::urem(i, j), context.bv_val(0, 32)); // remainder
+    z3::expr res = ite(j != 0, z3::urem(i, j), type.Value(context, 0)); // remainder
 
     // we just care about the upper bound tightness
     solver.add(res == emax);
 
-    z3::check_result ans = solver.check();
-
-    if (ans == z3::unsat) {
-        std::cout << " NOT tight." << std::endl;
-    } else if (ans == z3::unknown) {
-        std::cout << " Unknown." << std::endl;
-    } else {
-        std::cout << " Tight." << std::endl;
-    }
+    report_tightness(solve(solver));
 
-    std::cout << "-------------------" << std::endl;
+    rule_output() << "-------------------" << std::endl;
 }
 
 
 void test_mod_unsigned_bounded_fix_nonzero() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test <any> % bounded unsigned not 0 Mod fix" << std::endl;
-    z3::context context;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test <any> % bounded unsigned not 0 Mod fix" << std::endl;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    // need to write this manually to use bit vectors (unsigned)
-    z3::expr a0 = context.bv_const("a0", 32);
-    z3::expr a1 = context.bv_const("a1", 32);
-    solver.add(z3::uge(a1, a0));
-
-    z3::expr b0 = context.bv_const("b0", 32);
-    z3::expr b1 = context.bv_const("b1", 32);
-    solver.add(z3::uge(b1, b0));
-    
-    z3::expr emin = context.bv_val(0, 32);
-    z3::expr emax = ite(b1 == 0, context.bv_val(0, 32), b1 - 1);
+    const HalideType type = HalideType::UInt(32);
+    z3::expr a0 = type.Variable(context, "a0");
+    z3::expr a1 = type.Variable(context, "a1");
+    solver.add(type.LessEqual(a0, a1));
+
+    z3::expr b0 = type.Variable(context, "b0");
+    z3::expr b1 = type.Variable(context, "b1");
+    solver.add(type.LessEqual(b0, b1));
     
-    max(emin, b1 - 1);
+    z3::expr emin = type.Value(context, 0);
+    z3::expr emax = ite(b1 == 0, type.Value(context, 0), b1 - 1);
 
-    z3::expr i = context.bv_const("i", 32);
-    z3::expr j = context.bv_const("j", 32);
+    z3::expr i = type.Variable(context, "i");
+    z3::expr j = type.Variable(context, "j");
 
-    // fully bounded
-    solver.add(z3::uge(a0, i)); // a0 <= i
-    solver.add(z3::uge(i, a1)); // i <= a1
-    solver.add(z3::uge(b0, j)); // b0 <= j
-    solver.add(z3::uge(j, b1)); // j <= b1
+    // fully bounded, the bounds reversed as in the original report, which
+    // pins i to a0 == a1 and j to b0 == b1
+    solver.add(type.LessEqual(i, a0));
+    solver.add(type.LessEqual(a1, i));
+    solver.add(type.LessEqual(j, b0));
+    solver.add(type.LessEqual(b1, j));
 
-    z3::expr res = ite(j != 0, z3::urem(i, j), context.bv_val(0, 32)); // remainder
+    z3::expr res = ite(j != 0, z3::urem(i, j), type.Value(context, 0)); // remainder
 
     // we just care about the upper bound tightness
     solver.add(res == emax);
 
-    z3::check_result ans = solver.check();
+    report_tightness(solve(solver));
 
-    if (ans == z3::unsat) {
-        std::cout << " NOT tight." << std::endl;
-    } else if (ans == z3::unknown) {
-        std::cout << " Unknown." << std::endl;
-    } else {
-        std::cout << " Tight." << std::endl;
-    }
-
-    std::cout << "-------------------" << std::endl;
+    rule_output() << "-------------------" << std::endl;
 }
 
+} // namespace
 
-
-int main(int argc, char** argv)
-{
-    test_mod_unsigned_bounded();
-    test_mod_unsigned_bounded_fix_zero();
-    test_mod_unsigned_bounded_fix_nonzero();
-}
\ No newline at end of file
+static RuleGroup rules("mod-check", "mod", {"bv", "bug"}, {
+    RULE(test_mod_unsigned_bounded),
+    RULE(test_mod_unsigned_bounded_fix_zero),
+    RULE(test_mod_unsigned_bounded_fix_nonzero),
+});
@@ -1,32 +1,34 @@
 #include "Interval.h"
 #include "Check.h"
+#include "ContextPool.h"
 #include "Operations.h"
+#include "Overflow.h"
 #include <vector>
+#include "Registry.h"
+#include "Report.h"
 
 #define NBITS 8
 
+namespace {
+
 // TODO: need framework for doing bv intervals
-// don't let i << j overflow
+// don't let i << j overflow, res is i << j wherever j >= 0
 void disallow_overflow(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool iIsUint, bool jIsUint, z3::solver &solver) {
     z3::expr jpos = (jIsUint || (j >= 0));
-    z3::expr pos_bit_count = (count_set_bits(i, NBITS) != count_set_bits(res, NBITS)) && (iIsUint || (i >= 0));
-    z3::expr i_sign_mask = z3::ashr((i & (1 << (NBITS-1))), NBITS);
-    z3::expr j_sign_mask = z3::ashr((j & (1 << (NBITS-1))), NBITS);
-    z3::expr extend_i = concat(i_sign_mask, i);
-    z3::expr extend_j = concat(j_sign_mask, j);
+    z3::expr pos_bit_count = shl_drops_bits(i, j) && (iIsUint || (i >= 0));
     uint32_t mask = 0xffffffff >> (32 - (NBITS)); // mask of NBITS 1s, which is INT_MIN for NBITS
     z3::expr int_min = i.ctx().bv_val(mask, NBITS * 2);
-    z3::expr neg_overflow = (iIsUint) ? (i.ctx().bool_val(false)) : (left_shift(extend_i, extend_j, iIsUint, jIsUint) < int_min);
+    z3::expr neg_overflow = (iIsUint) ? (i.ctx().bool_val(false)) : (wide_shl(i, j) < int_min);
     // sign change on an integer is overflow, the false can be optimized out
     z3::expr sign_change = (iIsUint) ? (i.ctx().bool_val(false)) : ((i > 0) && res < 0);
     solver.add(!(jpos && (pos_bit_count || sign_change || neg_overflow)));
 }
 
-void check_shift_left(ShiftParams &a_params, ShiftParams &b_params, bool isUpperBound,
+CheckResult check_shift_left(ShiftParams &a_params, ShiftParams &b_params, bool isUpperBound,
                         const z3::expr &bound, z3::solver &solver, z3::context &context) {
     
-    z3::expr i = context.bv_const("i", NBITS);
-    z3::expr j = context.bv_const("j", NBITS);
+    z3::expr i = bv_symbol(context, "i", NBITS);
+    z3::expr j = bv_symbol(context, "j", NBITS);
     if (b_params.isUint) {
         solver.add(z3::ult(j, NBITS));
     } else {
@@ -54,42 +56,35 @@ void check_shift_left(ShiftParams &a_params, ShiftParams &b_params, bool isUpper
         }
     }
 
-    z3::check_result ans = solver.check();
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        std::cout << a_params.toString(model);
-        std::cout << " << ";
-        std::cout << b_params.toString(model) << std::endl;
-        std::cout << "Resultant bounds: [";
+    CheckResult result = solve(solver, [=](std::ostream &out, z3::model &model) {
+        out << a_params.toString(model);
+        out << " << ";
+        out << b_params.toString(model) << std::endl;
+        out << "Resultant bounds: [";
         if (isUpperBound) {
-            std::cout << "_, " << model.eval(bound);
+            out << "_, " << model.eval(bound);
         } else {
-            std::cout << model.eval(bound) << ", _";
+            out << model.eval(bound) << ", _";
         }
-        std::cout << "]" << std::endl;
-
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(i);
-        std::cout << " << ";
-        std::cout << model.eval(j);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
+        out << "]" << std::endl;
+
+        out << "Contradiction: ";
+        out << model.eval(i);
+        out << " << ";
+        out << model.eval(j);
+        out << " = " << model.eval(res) << std::endl;
+    });
+    return result;
 }
 
 
 
-void check_shift_left(bool isUpperBound, const z3::expr &a_bound, const z3::expr &b_bound,
+CheckResult check_shift_left(bool isUpperBound, const z3::expr &a_bound, const z3::expr &b_bound,
                         bool aIsUint, bool bIsUint, const z3::expr &bound, z3::solver &solver, z3::context &context) {
 
-    const z3::expr zero = context.bv_val(0x0ull, NBITS);
-    z3::expr i = context.bv_const("i", NBITS);
-    z3::expr j = context.bv_const("j", NBITS);
+    const z3::expr zero = context.bv_val(0, NBITS);
+    z3::expr i = bv_symbol(context, "i", NBITS);
+    z3::expr j = bv_symbol(context, "j", NBITS);
     solver.add(j < NBITS); // otherwise UB
 
     if (isUpperBound) {
@@ -137,31 +132,24 @@ void check_shift_left(bool isUpperBound, const z3::expr &a_bound, const z3::expr
         }
     }
     
-    z3::check_result ans = solver.check();
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
+    CheckResult result = solve(solver, [=](std::ostream &out, z3::model &model) {
         if (isUpperBound) {
-            std::cout << "[_, " << model.eval(a_bound) << "] << ";
-            std::cout << "[_, " << model.eval(b_bound) << "]" << std::endl;
-            std::cout << "Resultant bounds: [_, " << model.eval(bound) << "]" << std::endl;
+            out << "[_, " << model.eval(a_bound) << "] << ";
+            out << "[_, " << model.eval(b_bound) << "]" << std::endl;
+            out << "Resultant bounds: [_, " << model.eval(bound) << "]" << std::endl;
         } else {
-            std::cout << "[" << model.eval(a_bound) << ", _] << ";
-            std::cout << "[" << model.eval(b_bound) << ", _]" << std::endl;
-            std::cout << "Resultant bounds: [" << model.eval(bound) << ", _]" << std::endl;
+            out << "[" << model.eval(a_bound) << ", _] << ";
+            out << "[" << model.eval(b_bound) << ", _]" << std::endl;
+            out << "Resultant bounds: [" << model.eval(bound) << ", _]" << std::endl;
         }
 
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(i);
-        std::cout << " << ";
-        std::cout << model.eval(j);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
+        out << "Contradiction: ";
+        out << model.eval(i);
+        out << " << ";
+        out << model.eval(j);
+        out << " = " << model.eval(res) << std::endl;
+    });
+    return result;
 }
 
 /*
@@ -174,14 +162,14 @@ else if (a_interval.has_lower_bound() &&
 }
 */
 void bug_lower_bound_lshift_neg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Original for [a0, _] << [b0, _] && b0 < 0 && b0 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Original for [a0, _] << [b0, _] && b0 < 0 && b0 > -t.bits()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
+    z3::expr a0 = bv_symbol(context, "a0", NBITS);
+    z3::expr b0 = bv_symbol(context, "b0", NBITS);
     bool aIsUint = false;
     bool bIsUint = false;
 
@@ -193,19 +181,19 @@ void bug_lower_bound_lshift_neg() {
     z3::expr emin = z3::ashr(a0, b0 * -1);
     // overflow not possible with right shift
 
-    check_shift_left(false, a0, b0, aIsUint, bIsUint, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(false, a0, b0, aIsUint, bIsUint, emin, solver, context));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void fix_pos_lower_bound_lshift_neg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Fix for [a0(+), _] << [b0, _] && b0 < 0 && b0 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Fix for [a0(+), _] << [b0, _] && b0 < 0 && b0 > -t.bits()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
+    z3::expr a0 = bv_symbol(context, "a0", NBITS);
+    z3::expr b0 = bv_symbol(context, "b0", NBITS);
     bool aIsUint = false;
     bool bIsUint = false;
 
@@ -219,21 +207,21 @@ void fix_pos_lower_bound_lshift_neg() {
     z3::expr emin = z3::ashr(a0, b0 * -1);
     // overflow not possible with right shift
 
-    check_shift_left(false, a0, b0, aIsUint, bIsUint, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(false, a0, b0, aIsUint, bIsUint, emin, solver, context));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void fix_neg_full_bound_lshift_neg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Fix for [a0(-), _] << [b0, b1] && b0 < 0 && b0 > -t.bits() && b1 <= 0" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Fix for [a0(-), _] << [b0, b1] && b0 < 0 && b0 > -t.bits() && b1 <= 0" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr unb = context.bv_const("unb", NBITS); // used for default unbounded arg
+    z3::expr unb = bv_symbol(context, "unb", NBITS); // used for default unbounded arg
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a0 = bv_symbol(context, "a0", NBITS);
+    z3::expr b0 = bv_symbol(context, "b0", NBITS);
+    z3::expr b1 = bv_symbol(context, "b1", NBITS);
     bool aIsUint = false;
     bool bIsUint = false;
 
@@ -252,21 +240,21 @@ void fix_neg_full_bound_lshift_neg() {
     ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=aIsUint, .upper=unb, .lower=a0};
     ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=false, .isUint=bIsUint, .upper=b1, .lower=unb};
 
-    check_shift_left(a_params, b_params, /*isUpperBound*/false, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(a_params, b_params, /*isUpperBound*/false, emin, solver, context));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void fix_neg_full_bound_lshift_possibly_neg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Fix for [a0(-), _] << [b0, b1] && b0 < 0 && b0 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Fix for [a0(-), _] << [b0, b1] && b0 < 0 && b0 > -t.bits()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr unb = context.bv_const("unb", NBITS); // used for default unbounded arg
+    z3::expr unb = bv_symbol(context, "unb", NBITS); // used for default unbounded arg
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    // z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a0 = bv_symbol(context, "a0", NBITS);
+    // z3::expr b0 = bv_symbol(context, "b0", NBITS);
+    z3::expr b1 = bv_symbol(context, "b1", NBITS);
     bool aIsUint = false;
     bool bIsUint = false;
 
@@ -285,20 +273,20 @@ void fix_neg_full_bound_lshift_possibly_neg() {
     ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=aIsUint, .upper=unb, .lower=a0};
     ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=false, .isUint=bIsUint, .upper=b1, .lower=unb};
 
-    check_shift_left(a_params, b_params, /*isUpperBound*/false, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(a_params, b_params, /*isUpperBound*/false, emin, solver, context));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void fix_pos_full_bound_lshift_ub_nonpos() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Fix for [a0(+), _] << [_, _]" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Fix for [a0(+), _] << [_, _]" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr unb = context.bv_const("unb", NBITS); // used for default unbounded arg
+    z3::expr unb = bv_symbol(context, "unb", NBITS); // used for default unbounded arg
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a0 = bv_symbol(context, "a0", NBITS);
+    z3::expr b1 = bv_symbol(context, "b1", NBITS);
     bool aIsUint = false;
     bool bIsUint = false;
 
@@ -312,15 +300,17 @@ void fix_pos_full_bound_lshift_ub_nonpos() {
     ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=aIsUint, .upper=unb, .lower=a0};
     ShiftParams b_params = {.isUpperBounded=false, .isLowerBounded=false, .isUint=bIsUint, .upper=unb, .lower=unb};
 
-    check_shift_left(a_params, b_params, /*isUpperBound*/false, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(a_params, b_params, /*isUpperBound*/false, emin, solver, context));
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(int argc, char** argv) {
+} // namespace
+
+static RuleGroup rules("shift_left-check", "shift_left", {"bv", "bug"}, {
     // [-125, _] << [-7, _] |-> -66 << -1 = -33
-    bug_lower_bound_lshift_neg();
-    fix_pos_lower_bound_lshift_neg();
-    fix_neg_full_bound_lshift_neg();
-    fix_neg_full_bound_lshift_possibly_neg();
-    fix_pos_full_bound_lshift_ub_nonpos();
-}
\ No newline at end of file
+    RULE(bug_lower_bound_lshift_neg),
+    RULE(fix_pos_lower_bound_lshift_neg),
+    RULE(fix_neg_full_bound_lshift_neg),
+    RULE(fix_neg_full_bound_lshift_possibly_neg),
+    RULE(fix_pos_full_bound_lshift_ub_nonpos),
+});
@@ -1,8 +1,15 @@
 #include "Interval.h"
 #include "Check.h"
+#include "ContextPool.h"
 #include "Operations.h"
+#include "Overflow.h"
+#include "Registry.h"
+#include "Report.h"
 
 #define NBITS 8
+
+namespace {
+
 // TODO: need framework for doing bv intervals
 
 // struct ShiftParams {
@@ -31,21 +38,21 @@
 //     }
 // }
 
-// no overflow for i >> j
+// no overflow for i >> j, res is i << -j wherever j < 0
 void disallow_overflow(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool aIsUint, z3::solver &solver) {
     z3::expr jneg = (j < 0);
-    z3::expr bad_bit_count = (count_set_bits(i, NBITS) != count_set_bits(res, NBITS));
+    z3::expr bad_bit_count = shl_drops_bits(i, -j);
     // sign change on an integer is overflow, the false can be optimized out
     z3::expr sign_change = (aIsUint) ? (i.ctx().bool_val(false)) : ((i > 0) && res < 0);
     // overflow only UB for Int(32) and Int(64)
     solver.add(!(!aIsUint && jneg && (bad_bit_count || sign_change)));
 }
 
-void check_shift_right(ShiftParams &a_params, ShiftParams &b_params, bool isUpperBounded, bool isUint,
+CheckResult check_shift_right(ShiftParams &a_params, ShiftParams &b_params, bool isUpperBounded, bool isUint,
                         const z3::expr &bound, z3::solver &solver, z3::context &context) {
     
-    z3::expr i = context.bv_const("i", NBITS);
-    z3::expr j = context.bv_const("j", NBITS);
+    z3::expr i = bv_symbol(context, "i", NBITS);
+    z3::expr j = bv_symbol(context, "j", NBITS);
     if (b_params.isUint) {
         solver.add(z3::ult(j, NBITS));
     } else {
@@ -88,62 +95,52 @@ void check_shift_right(ShiftParams &a_params, ShiftParams &b_params, bool isUppe
         }
     }
 
-    z3::check_result ans = solver.check();
-    if (ans == z3::unsat) {
-        // std::cout << solver.to_smt2() << std::endl;
-        std::cout << "proved" << std::endl;
-    } else if(ans == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else {
-        // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-        std::cout << model << std::endl;
-
+    CheckResult result = solve(solver, [=](std::ostream &out, z3::model &model) {
         // print a
-        std::cout << "[";
+        out << "[";
         if (a_params.isLowerBounded) {
-            std::cout << model.eval(a_params.lower);
+            out << model.eval(a_params.lower);
         } else {
-            std::cout << "_";
+            out << "_";
         }
-        std::cout << ", ";
+        out << ", ";
         if (a_params.isUpperBounded) {
-            std::cout << model.eval(a_params.upper);
+            out << model.eval(a_params.upper);
         } else {
-            std::cout << "_";
+            out << "_";
         }
 
-        std::cout << "] >> [";
+        out << "] >> [";
 
         // print b
         if (b_params.isLowerBounded) {
-            std::cout << model.eval(b_params.lower);
+            out << model.eval(b_params.lower);
         } else {
-            std::cout << "_";
+            out << "_";
         }
-        std::cout << ", ";
+        out << ", ";
         if (b_params.isUpperBounded) {
-            std::cout << model.eval(b_params.upper);
+            out << model.eval(b_params.upper);
         } else {
-            std::cout << "_";
+            out << "_";
         }
         
-        std::cout << "] = ";
+        out << "] = ";
 
         // print calculated bounds
         if (isUpperBounded) {
-            std::cout << "[_, " << model.eval(bound) << "]" << std::endl;
+            out << "[_, " << model.eval(bound) << "]" << std::endl;
         } else {
-            std::cout << "[" << model.eval(bound) << ", _]" << std::endl;
+            out << "[" << model.eval(bound) << ", _]" << std::endl;
         }
 
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(i);
-        std::cout << " >> ";
-        std::cout << model.eval(j);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
+        out << "Contradiction: ";
+        out << model.eval(i);
+        out << " >> ";
+        out << model.eval(j);
+        out << " = " << model.eval(res) << std::endl;
+    });
+    return result;
 }
 
 /*
@@ -161,17 +158,17 @@ must try:
     int >> uint
 */
 void bug_pos_uint_lb_rshift_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Original for u[a0, _] >> [b0, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Original for u[a0, _] >> [b0, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    z3::expr zero = context.bv_val(0, NBITS);
 
-    z3::expr a0 = context.bv_const("a0", NBITS); // a is unsigned
+    z3::expr a0 = bv_symbol(context, "a0", NBITS); // a is unsigned
 
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = bv_symbol(context, "b0", NBITS);
+    z3::expr b1 = bv_symbol(context, "b1", NBITS);
 
     // treat b like an integer
     solver.add(b0 <= b1);
@@ -187,22 +184,22 @@ void bug_pos_uint_lb_rshift_int() {
     ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
 
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */true, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */true, emin, solver, context));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void fix_pos_uint_lb_rshift_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Fix for u[a0, _] >> [b0, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Fix for u[a0, _] >> [b0, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    z3::expr zero = context.bv_val(0, NBITS);
 
-    z3::expr a0 = context.bv_const("a0", NBITS); // a is unsigned
+    z3::expr a0 = bv_symbol(context, "a0", NBITS); // a is unsigned
 
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = bv_symbol(context, "b0", NBITS);
+    z3::expr b1 = bv_symbol(context, "b1", NBITS);
 
     // treat b like an integer
     solver.add(b0 <= b1);
@@ -218,8 +215,8 @@ void fix_pos_uint_lb_rshift_int() {
     ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
 
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */true, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */true, emin, solver, context));
+    rule_output() << "-------------------" << std::endl;
 }
 
 /*
@@ -239,16 +236,16 @@ Note: b must be signed, only two cases:
 
 */
 void test_unk_uint_lb_rshift_neg_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[a0, _] >> [b0, b1] && b0, b1 < 0 && b0, b1 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[a0, _] >> [b0, b1] && b0, b1 < 0 && b0, b1 > -t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    z3::expr zero = context.bv_val(0, NBITS);
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a0 = bv_symbol(context, "a0", NBITS);
+    z3::expr b0 = bv_symbol(context, "b0", NBITS);
+    z3::expr b1 = bv_symbol(context, "b1", NBITS);
     solver.add(b0 <= b1);
     // b is signed
     solver.add(b0 < 0);
@@ -270,8 +267,8 @@ void test_unk_uint_lb_rshift_neg_int() {
     ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
 
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */true, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */true, emin, solver, context));
+    rule_output() << "-------------------" << std::endl;
 }
 
 /*
@@ -291,16 +288,16 @@ must try:
     uint >> int
 */
 void test_unk_uint_ub_rshift_neg_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[_, a1] >> [b0, b1] && b0, b1 < 0 && b0, b1 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[_, a1] >> [b0, b1] && b0, b1 < 0 && b0, b1 > -t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    z3::expr zero = context.bv_val(0, NBITS);
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a1 = bv_symbol(context, "a1", NBITS);
+    z3::expr b0 = bv_symbol(context, "b0", NBITS);
+    z3::expr b1 = bv_symbol(context, "b1", NBITS);
     // b is signed
     solver.add(b0 <= b1);
     solver.add(b0 < 0);
@@ -323,13 +320,15 @@ void test_unk_uint_ub_rshift_neg_int() {
     ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
 
     // output is upper bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */true, /* isUint */true, emax, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(a_params, b_params, /* isUpperBounded */true, /* isUint */true, emax, solver, context));
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(int argc, char** argv) {
-    bug_pos_uint_lb_rshift_int();
-    fix_pos_uint_lb_rshift_int();
-    test_unk_uint_lb_rshift_neg_int(); // bug
-    test_unk_uint_ub_rshift_neg_int(); // bug
-}
\ No newline at end of file
+} // namespace
+
+static RuleGroup rules("shift_right-check", "shift_right", {"bv", "bug"}, {
+    RULE(bug_pos_uint_lb_rshift_int),
+    RULE(fix_pos_uint_lb_rshift_int),
+    RULE(test_unk_uint_lb_rshift_neg_int), // bug
+    RULE(test_unk_uint_ub_rshift_neg_int), // bug
+});
@@ -1,22 +1,27 @@
 #include "Interval.h"
 #include "Check.h"
+#include "ContextPool.h"
+#include "Registry.h"
+#include "Report.h"
+
+namespace {
 
 void test_single_point() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test single point Add" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Point, 
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test single point Add" << std::endl;
+    z3::context &c = rule_context();
+    Interval a = MakeInterval(c, "a", IntervalType::Point, 
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point, 
+    Interval b = MakeInterval(c, "b", IntervalType::Point, 
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr b0 = b->GetLower();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b0 = b.GetLower();
+    z3::expr b1 = b.GetUpper();
 
     z3::expr emin = a0 + b0;
     z3::expr emax = a1 + b1;
@@ -24,27 +29,28 @@ void test_single_point() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Add, a, b, e0, e1);
-    check_tightness(c, Operation::Add, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Add, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test bounded Add" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::NotPoint, 
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test bounded Add" << std::endl;
+    z3::context &c = rule_context();
+    Interval a = MakeInterval(c, "a", IntervalType::NotPoint, 
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::NotPoint, 
+    Interval b = MakeInterval(c, "b", IntervalType::NotPoint, 
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr b0 = b->GetLower();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b0 = b.GetLower();
+    z3::expr b1 = b.GetUpper();
 
     z3::expr emin = a0 + b0;
     z3::expr emax = a1 + b1;
@@ -52,27 +58,28 @@ void test_bounded() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Add, a, b, e0, e1);
-    check_tightness(c, Operation::Add, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Add, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_upper_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test upper bounded Add" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown, 
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test upper bounded Add" << std::endl;
+    z3::context &c = rule_context();
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown, 
         NoRestriction, BoundType::Unbounded, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Unknown, 
+    Interval b = MakeInterval(c, "b", IntervalType::Unknown, 
         NoRestriction, BoundType::Unbounded, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr b0 = b->GetLower();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b0 = b.GetLower();
+    z3::expr b1 = b.GetUpper();
 
     z3::expr emin(c); // not used
     z3::expr emax = a1 + b1;
@@ -80,27 +87,28 @@ void test_upper_bounded() {
     Bound e0(NoRestriction, BoundType::Unbounded, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Add, a, b, e0, e1);
-    check_tightness(c, Operation::Add, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Add, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_lower_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test lower bounded Add" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown, 
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test lower bounded Add" << std::endl;
+    z3::context &c = rule_context();
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown, 
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::Unbounded); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Unknown, 
+    Interval b = MakeInterval(c, "b", IntervalType::Unknown, 
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::Unbounded); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr b0 = b->GetLower();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b0 = b.GetLower();
+    z3::expr b1 = b.GetUpper();
 
     z3::expr emin = a0 + b0;
     z3::expr emax(c); // not used
@@ -108,16 +116,17 @@ void test_lower_bounded() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::Unbounded, emax);
 
-    check(c, Operation::Add, a, b, e0, e1);
-    check_tightness(c, Operation::Add, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Add, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
+} // namespace
 
-int main(int argc, char** argv)
-{
-    test_single_point();
-    test_bounded();
-    test_upper_bounded();
-    test_lower_bounded();
-}
\ No newline at end of file
+static RuleGroup rules("add", "add", {"int"}, {
+    RULE(test_single_point),
+    RULE(test_bounded),
+    RULE(test_upper_bounded),
+    RULE(test_lower_bounded),
+});
@@ -1,165 +1,124 @@
-#include "Interval.h"
+#include <algorithm>
+
+#include "BVInterval.h"
 #include "Check.h"
+#include "ContextPool.h"
+#include "Exhaustive.h"
+#include "Registry.h"
+#include "Report.h"
 
-#define NBITS 32
+namespace {
 
-// TODO: need framework for doing bv intervals
+template<unsigned Width>
 void test_unknown_and_pos_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test a (unknown) bounded & b (>= 0) bounded" << std::endl;
-    
-    z3::context context;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test a (unknown) bounded & b (>= 0) bounded" << std::endl;
+
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr a1 = context.bv_const("a1", NBITS);
-    solver.add(a1 >= a0);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr a1 = Int::Variable(context, "a1");
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     solver.add(b0 >= 0);
-    solver.add(b1 >= b0);
-
-    z3::expr emin = context.bv_val(0, NBITS);      // lower bound
-    z3::expr emax = b1;               // upper bound
 
-    z3::expr i = context.bv_const("i", NBITS);
-    z3::expr j = context.bv_const("j", NBITS);
-    solver.add(a0 <= i && i <= a1); // a0 <= i <= a1
-    solver.add(b0 <= j && j <= b1); // b0 <= j <= b1
+    z3::expr emin = Int::Value(context, 0);     // lower bound
+    z3::expr emax = b1;                         // upper bound
 
+    z3::expr i = Int::Variable(context, "i");
+    z3::expr j = Int::Variable(context, "j");
     z3::expr res = i & j;
-    
-    // if possible to be less than our min or more than our max, BAD
-    solver.add(res < emin || res > emax);
-    
-    z3::check_result ans = solver.check();
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        std::cout << "Resultant bounds: [" << model.eval(emin);
-        std::cout << ", " << model.eval(emax) << "]";
-
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(i);
-        std::cout << " & ";
-        std::cout << model.eval(j);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
-    std::cout << "-------------------" << std::endl;
+
+    report(check_bv(solver, "&", Int(a0, a1), i, Int(b0, b1), j, res, Int(emin, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_pos_and_pos_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test a (>= 0) bounded & b (>= 0) bounded" << std::endl;
-    
-    z3::context context;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test a (>= 0) bounded & b (>= 0) bounded" << std::endl;
+
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr a1 = context.bv_const("a1", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr a1 = Int::Variable(context, "a1");
     solver.add(a0 >= 0);
-    solver.add(a1 >= a0);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     solver.add(b0 >= 0);
-    solver.add(b1 >= b0);
 
-    z3::expr emin = context.bv_val(0, NBITS);       // lower bound
-    z3::expr emax = min(a1, b1);                    // upper bound
-
-    z3::expr i = context.bv_const("i", NBITS);
-    z3::expr j = context.bv_const("j", NBITS);
-    solver.add(a0 <= i && i <= a1); // a0 <= i <= a1
-    solver.add(b0 <= j && j <= b1); // b0 <= j <= b1
+    z3::expr emin = Int::Value(context, 0);     // lower bound
+    z3::expr emax = Int::Min(a1, b1);           // upper bound
 
+    z3::expr i = Int::Variable(context, "i");
+    z3::expr j = Int::Variable(context, "j");
     z3::expr res = i & j;
-    
-    // if possible to be less than our min or more than our max, BAD
-    solver.add(res < emin || res > emax);
-    
-    z3::check_result ans = solver.check();
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        std::cout << "Resultant bounds: [" << model.eval(emin);
-        std::cout << ", " << model.eval(emax) << "]";
-
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(i);
-        std::cout << " & ";
-        std::cout << model.eval(j);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
-    std::cout << "-------------------" << std::endl;
+
+    report(check_bv(solver, "&", Int(a0, a1), i, Int(b0, b1), j, res, Int(emin, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
 
+template<unsigned Width>
 void test_unknown_and_unknown_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [int] a (unknown) bounded & b (unknown) bounded" << std::endl;
-    
-    z3::context context;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [int] a (unknown) bounded & b (unknown) bounded" << std::endl;
+
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr a1 = context.bv_const("a1", NBITS);
-    solver.add(a1 >= a0);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
-    solver.add(b1 >= b0);
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr a1 = Int::Variable(context, "a1");
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
 
     // no lower bound
-    z3::expr emax = ite(a1 > b1, a1, b1); // want signed max (int)
-    
-    z3::expr i = context.bv_const("i", NBITS);
-    z3::expr j = context.bv_const("j", NBITS);
-    solver.add(a0 <= i && i <= a1); // a0 <= i <= a1
-    solver.add(b0 <= j && j <= b1); // b0 <= j <= b1
+    z3::expr emax = Int::Max(a1, b1);           // want signed max (int)
 
+    z3::expr i = Int::Variable(context, "i");
+    z3::expr j = Int::Variable(context, "j");
     z3::expr res = i & j;
-    
-    // if possible to be less than our min or more than our max, BAD
-    solver.add(res > emax);
-    
-    z3::check_result ans = solver.check();
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        std::cout << "[" << model.eval(a0);
-        std::cout << ", " << model.eval(a1) << "] ";
-        std::cout << "&";
-        std::cout << " [" << model.eval(b0);
-        std::cout << ", " << model.eval(b1) << "]" << std::endl;
-
-        std::cout << "Resultant bounds: [_, " << model.eval(emax) << "]" << std::endl;
-
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(i);
-        std::cout << " & ";
-        std::cout << model.eval(j);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
-    std::cout << "-------------------" << std::endl;
-}
 
+    report(check_bv(solver, "&", Int(a0, a1), i, Int(b0, b1), j, res, Int(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
+}
 
-int main(int argc, char** argv) {
-    test_unknown_and_pos_bounded();
-    test_pos_and_pos_bounded();
-    test_unknown_and_unknown_bounded();
-}
\ No newline at end of file
+} // namespace
+
+static RuleGroup rules("bitwise_and", "bitwise_and", {"bv"}, {
+    BV_RULE(test_unknown_and_pos_bounded, 32),
+    BV_RULE(test_pos_and_pos_bounded, 32),
+    BV_RULE(test_unknown_and_unknown_bounded, 32),
+});
+
+// the same rules at 8 bits, for --exhaustive
+static ExhaustiveGroup exhaustive("bitwise_and", {
+    {"unknown_and_pos_bounded", {true, BothEnds, true, BothEnds, bitwise_and8<true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 < 0) {
+                return false;
+            }
+            lo = 0;
+            hi = b1;
+            return true;
+        }, BothEnds, "&"}},
+    {"pos_and_pos_bounded", {true, BothEnds, true, BothEnds, bitwise_and8<true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (a0 < 0 || b0 < 0) {
+                return false;
+            }
+            lo = 0;
+            hi = std::min(a1, b1);
+            return true;
+        }, BothEnds, "&"}},
+    {"unknown_and_unknown_bounded", {true, BothEnds, true, BothEnds, bitwise_and8<true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            hi = std::max(a1, b1);
+            return true;
+        }, UpperEnd, "&"}},
+});
@@ -1,92 +1,56 @@
-#include "Interval.h"
+#include "BVInterval.h"
 #include "Check.h"
+#include "ContextPool.h"
+#include "Registry.h"
+#include "Report.h"
 
-#define NBITS 32
+namespace {
 
-// TODO: need framework for doing bv intervals
+template<unsigned Width>
 void test_not_upper_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test ~a (unknown) upper bounded" << std::endl;
-    
-    z3::context context;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test ~a (unknown) upper bounded" << std::endl;
+
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
+    z3::expr a1 = Int::Variable(context, "a1");
 
     // no upper bound
     z3::expr emin = ~a1;
-    
-    z3::expr i = context.bv_const("i", NBITS);
-    solver.add(i <= a1);
 
+    z3::expr i = Int::Variable(context, "i");
     z3::expr res = ~i;
-    
-    // if possible to be less than our min or more than our max, BAD
-    solver.add(res < emin);
-    
-    z3::check_result ans = solver.check();
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        std::cout << "! [_, " << model.eval(a1);
-        std::cout << "]" << std::endl;
 
-        std::cout << "Resultant bounds: [" << model.eval(emin) << ", _]" << std::endl;
-
-        std::cout << "Contradiction: ~";
-        std::cout << model.eval(i);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
-    std::cout << "-------------------" << std::endl;
+    report(check_bv(solver, "~", Int(std::nullopt, a1), i, res, Int(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_not_lower_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test ~a (unknown) lower bounded" << std::endl;
-    
-    z3::context context;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test ~a (unknown) lower bounded" << std::endl;
+
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
 
     // no lower bound
     z3::expr emax = ~a0;
-    
-    z3::expr i = context.bv_const("i", NBITS);
-    solver.add(i >= a0);
 
+    z3::expr i = Int::Variable(context, "i");
     z3::expr res = ~i;
-    
-    // if possible to be less than our min or more than our max, BAD
-    solver.add(res > emax);
-    
-    z3::check_result ans = solver.check();
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
 
-        std::cout << "! [" << model.eval(a0);
-        std::cout << ", _]" << std::endl;
-
-        std::cout << "Resultant bounds: [_, " << model.eval(emax) << "]" << std::endl;
-
-        std::cout << "Contradiction: ~";
-        std::cout << model.eval(i);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
-    std::cout << "-------------------" << std::endl;
+    report(check_bv(solver, "~", Int(a0, std::nullopt), i, res, Int(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(int argc, char** argv) {
-    test_not_upper_bounded();
-    test_not_lower_bounded();
-}
\ No newline at end of file
+} // namespace
+
+static RuleGroup rules("bitwise_not", "bitwise_not", {"bv"}, {
+    BV_RULE(test_not_upper_bounded, 32),
+    BV_RULE(test_not_lower_bounded, 32),
+});
@@ -1,109 +1,80 @@
-#include "Interval.h"
+#include <algorithm>
+
+#include "BVInterval.h"
 #include "Check.h"
+#include "ContextPool.h"
+#include "Exhaustive.h"
+#include "Registry.h"
+#include "Report.h"
 
-#define NBITS 32
+namespace {
 
-// TODO: need framework for doing bv intervals
+template<unsigned Width>
 void test_integer_or_lower_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [int] a (unknown) lower bounded & b (unknown) lower bounded" << std::endl;
-    
-    z3::context context;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [int] a (unknown) lower bounded & b (unknown) lower bounded" << std::endl;
+
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr b0 = Int::Variable(context, "b0");
 
     // no upper bound
-    z3::expr emin = ite(a0 > b0, b0, a0); // want signed min (int)
-    
-    z3::expr i = context.bv_const("i", NBITS);
-    z3::expr j = context.bv_const("j", NBITS);
-    solver.add(a0 <= i);
-    solver.add(b0 <= j);
+    z3::expr emin = Int::Min(a0, b0);           // want signed min (int)
 
+    z3::expr i = Int::Variable(context, "i");
+    z3::expr j = Int::Variable(context, "j");
     z3::expr res = i | j;
-    
-    // if possible to be less than our min or more than our max, BAD
-    solver.add(res < emin);
-    
-    z3::check_result ans = solver.check();
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        std::cout << "[" << model.eval(a0);
-        std::cout << ", _] ";
-        std::cout << "&";
-        std::cout << " [" << model.eval(b0);
-        std::cout << ", _]" << std::endl;
-
-        std::cout << "Resultant bounds: [" << model.eval(emin) << ", _]" << std::endl;
-
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(i);
-        std::cout << " & ";
-        std::cout << model.eval(j);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
-    std::cout << "-------------------" << std::endl;
+
+    report(check_bv(solver, "|", Int(a0, std::nullopt), i, Int(b0, std::nullopt), j, res,
+                    Int(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
 
+template<unsigned Width>
 void test_uninteger_or_lower_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [uint] a (unknown) lower bounded & b (unknown) lower bounded" << std::endl;
-    
-    z3::context context;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [uint] a (unknown) lower bounded & b (unknown) lower bounded" << std::endl;
+
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
+    z3::expr a0 = UInt::Variable(context, "a0");
+    z3::expr b0 = UInt::Variable(context, "b0");
 
     // no upper bound
-    z3::expr emin = ite(z3::ugt(a0, b0), a0, b0); // want unsigned max (uint)
-    
-    z3::expr i = context.bv_const("i", NBITS);
-    z3::expr j = context.bv_const("j", NBITS);
-    solver.add(z3::uge(i, a0));
-    solver.add(z3::uge(j, b0));
+    z3::expr emin = UInt::Max(a0, b0);          // want unsigned max (uint)
 
+    z3::expr i = UInt::Variable(context, "i");
+    z3::expr j = UInt::Variable(context, "j");
     z3::expr res = i | j;
-    
-    // if possible to be less than our min or more than our max, BAD
-    solver.add(z3::ult(res, emin));
-    
-    z3::check_result ans = solver.check();
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        std::cout << "[" << model.eval(a0);
-        std::cout << ", _] ";
-        std::cout << "&";
-        std::cout << " [" << model.eval(b0);
-        std::cout << ", _]" << std::endl;
-
-        std::cout << "Resultant bounds: [" << model.eval(emin) << ", _]" << std::endl;
-
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(i);
-        std::cout << " & ";
-        std::cout << model.eval(j);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
-    std::cout << "-------------------" << std::endl;
+
+    report(check_bv(solver, "|", UInt(a0, std::nullopt), i, UInt(b0, std::nullopt), j, res,
+                    UInt(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(int argc, char** argv) {
-    test_integer_or_lower_bounded();
-    test_uninteger_or_lower_bounded();
-}
\ No newline at end of file
+} // namespace
+
+static RuleGroup rules("bitwise_or", "bitwise_or", {"bv"}, {
+    BV_RULE(test_integer_or_lower_bounded, 32),
+    BV_RULE(test_uninteger_or_lower_bounded, 32),
+});
+
+// the same rules at 8 bits, for --exhaustive
+static ExhaustiveGroup exhaustive("bitwise_or", {
+    {"integer_or_lower_bounded", {true, LowerEnd, true, LowerEnd, bitwise_or8<true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            lo = std::min(a0, b0);
+            return true;
+        }, LowerEnd, "|"}},
+    {"uninteger_or_lower_bounded", {false, LowerEnd, false, LowerEnd, bitwise_or8<false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            lo = std::max(a0, b0);
+            return true;
+        }, LowerEnd, "|"}},
+});
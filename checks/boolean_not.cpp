@@ -1,4 +1,9 @@
+#include "ContextPool.h"
 #include "Interval.h"
+#include "Registry.h"
+#include "Report.h"
+
+namespace {
 
 z3::expr make_not(z3::expr &e) {
     return ite(
@@ -11,10 +16,10 @@ z3::expr make_not(z3::expr &e) {
 }
 
 void test_boolean_not() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test boolean !a" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test boolean !a" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval e("e", context, solver);
@@ -31,25 +36,20 @@ void test_boolean_not() {
     // binary choice
     solver.add(res != emin && res != emax);
     
-    z3::check_result ans = solver.check();
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        std::cout << "Resultant bounds: [" << model.eval(emin);
-        std::cout << ", " << model.eval(emax) << "]";
-
-        std::cout << "Contradiction: !";
-        std::cout << model.eval(e.inner);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
-    std::cout << "-------------------" << std::endl;
+    CheckResult result = solve(solver, [=](std::ostream &out, z3::model &model) {
+        out << "Resultant bounds: [" << model.eval(emin);
+        out << ", " << model.eval(emax) << "]";
+
+        out << "Contradiction: !";
+        out << model.eval(e.inner);
+        out << " = " << model.eval(res) << std::endl;
+    });
+    report(result);
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(void) {
-    test_boolean_not();
-}
\ No newline at end of file
+} // namespace
+
+static RuleGroup rules("boolean_not", "boolean_not", {"bool"}, {
+    RULE(test_boolean_not),
+});
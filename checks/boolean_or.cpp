@@ -1,4 +1,9 @@
+#include "ContextPool.h"
 #include "Interval.h"
+#include "Registry.h"
+#include "Report.h"
+
+namespace {
 
 z3::expr make_or(z3::expr &a, z3::expr &b) {
     return ite(
@@ -17,10 +22,10 @@ z3::expr make_or(z3::expr &a, z3::expr &b) {
 }
 
 void test_boolean_or() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test boolean a || b" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test boolean a || b" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval a("a", context, solver);
@@ -38,27 +43,22 @@ void test_boolean_or() {
     // binary choice
     solver.add(res != emin && res != emax);
     
-    z3::check_result ans = solver.check();
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        std::cout << "Resultant bounds: [" << model.eval(emin);
-        std::cout << ", " << model.eval(emax) << "]";
+    CheckResult result = solve(solver, [=](std::ostream &out, z3::model &model) {
+        out << "Resultant bounds: [" << model.eval(emin);
+        out << ", " << model.eval(emax) << "]";
 
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(a.inner);
-        std::cout << " && ";
-        std::cout << model.eval(b.inner);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
-    std::cout << "-------------------" << std::endl;
+        out << "Contradiction: ";
+        out << model.eval(a.inner);
+        out << " && ";
+        out << model.eval(b.inner);
+        out << " = " << model.eval(res) << std::endl;
+    });
+    report(result);
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(void) {
-    test_boolean_or();
-}
\ No newline at end of file
+} // namespace
+
+static RuleGroup rules("boolean_or", "boolean_or", {"bool"}, {
+    RULE(test_boolean_or),
+});
@@ -1,19 +1,22 @@
 #include "Interval.h"
 #include "Check.h"
+#include "Registry.h"
+#include "Report.h"
 
-void test_bounded_pos_unbounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test bounded positive / unbounded Div" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+namespace {
+
+void test_bounded_pos_unbounded(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test bounded positive / unbounded Div" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NonNegative, LowerBound, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(c, "b", IntervalType::Unknown,
         NoRestriction, Unbounded, // lower bound
         NoRestriction, Unbounded); // upper bound
 
-    z3::expr a1 = a->GetUpper();
+    z3::expr a1 = a.GetUpper();
 
     z3::expr emin = -a1;
     z3::expr emax = a1;
@@ -21,24 +24,24 @@ void test_bounded_pos_unbounded() {
     Bound e0(NoRestriction, LowerBound, emin);
     Bound e1(NoRestriction, UpperBound, emax);
 
-    check(c, Operation::Div, a, b, e0, e1);
-    check_tightness(c, Operation::Div, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Div, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_bounded_neg_unbounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test bounded negative / unbounded Div" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+void test_bounded_neg_unbounded(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test bounded negative / unbounded Div" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NoRestriction, LowerBound, // lower bound
         NonPositive, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(c, "b", IntervalType::Unknown,
         NoRestriction, Unbounded, // lower bound
         NoRestriction, Unbounded); // upper bound
 
-    z3::expr a0 = a->GetLower();
+    z3::expr a0 = a.GetLower();
 
     z3::expr emin = a0;
     z3::expr emax = -a0;
@@ -46,25 +49,25 @@ void test_bounded_neg_unbounded() {
     Bound e0(NoRestriction, LowerBound, emin);
     Bound e1(NoRestriction, UpperBound, emax);
 
-    check(c, Operation::Div, a, b, e0, e1);
-    check_tightness(c, Operation::Div, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Div, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_point_unbounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test point / unbounded Div" << std::endl;
-    z3::context c;
+void test_point_unbounded(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test point / unbounded Div" << std::endl;
 
-    Interval *a = MakeInterval(c, "a", IntervalType::Point,
+    Interval a = MakeInterval(c, "a", IntervalType::Point,
         NoRestriction, LowerBound, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(c, "b", IntervalType::Unknown,
         NoRestriction, Unbounded, // lower bound
         NoRestriction, Unbounded); // upper bound
 
-    z3::expr a0 = a->GetLower();
+    z3::expr a0 = a.GetLower();
 
     z3::expr emin = -z3_abs(a0);
     z3::expr emax = z3_abs(a0);
@@ -72,25 +75,25 @@ void test_point_unbounded() {
     Bound e0(NoRestriction, LowerBound, emin);
     Bound e1(NoRestriction, UpperBound, emax);
 
-    check(c, Operation::Div, a, b, e0, e1);
-    check_tightness(c, Operation::Div, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Div, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_bounded_unbounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test bounded / unbounded Div" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::NotPoint,
+void test_bounded_unbounded(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test bounded / unbounded Div" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::NotPoint,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(c, "b", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded, // lower bound
         NoRestriction, BoundType::Unbounded); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
 
     z3::expr emin = min(-a1, a0);
     z3::expr emax = max(-a0, a1);
@@ -98,25 +101,25 @@ void test_bounded_unbounded() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Div, a, b, e0, e1);
-    check_tightness(c, Operation::Div, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Div, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_single_points() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test single points Div" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Point,
+void test_single_points(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test single points Div" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Point,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point,
+    Interval b = MakeInterval(c, "b", IntervalType::Point,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
 
     z3::expr emin = halide_div(a0, b0);
     z3::expr emax = halide_div(a0, b0);
@@ -124,26 +127,26 @@ void test_single_points() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Div, a, b, e0, e1);
-    check_tightness(c, Operation::Div, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Div, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_bounded_single_pos() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test bounded / single pos point Div" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+void test_bounded_single_pos(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test bounded / single pos point Div" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point,
+    Interval b = MakeInterval(c, "b", IntervalType::Point,
         Positive, BoundType::LowerBound, // lower bound
         Positive, BoundType::UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr bp = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr bp = b.GetLower();
 
     z3::expr emin = halide_div(a0, bp);
     z3::expr emax = halide_div(a1, bp);
@@ -151,25 +154,25 @@ void test_bounded_single_pos() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Div, a, b, e0, e1);
-    check_tightness(c, Operation::Div, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Div, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_lower_bounded_single_pos() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test lower bounded / single pos point Div" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+void test_lower_bounded_single_pos(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test lower bounded / single pos point Div" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::Unbounded); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point,
+    Interval b = MakeInterval(c, "b", IntervalType::Point,
         Positive, BoundType::LowerBound, // lower bound
         Positive, BoundType::UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr bp = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr bp = b.GetLower();
 
     z3::expr emin = halide_div(a0, bp);
     z3::expr emax(c); // not used
@@ -177,25 +180,25 @@ void test_lower_bounded_single_pos() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::Unbounded, emax);
 
-    check(c, Operation::Div, a, b, e0, e1);
-    check_tightness(c, Operation::Div, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Div, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_upper_bounded_single_pos() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test upper bounded / single pos point Div" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+void test_upper_bounded_single_pos(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test upper bounded / single pos point Div" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point,
+    Interval b = MakeInterval(c, "b", IntervalType::Point,
         Positive, BoundType::LowerBound, // lower bound
         Positive, BoundType::UpperBound); // upper bound
 
-    z3::expr a1 = a->GetUpper();
-    z3::expr bp = b->GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr bp = b.GetLower();
 
     z3::expr emin(c); // not used
     z3::expr emax = halide_div(a1, bp);
@@ -203,26 +206,26 @@ void test_upper_bounded_single_pos() {
     Bound e0(NoRestriction, BoundType::Unbounded, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Div, a, b, e0, e1);
-    check_tightness(c, Operation::Div, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Div, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_bounded_single_neg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test bounded / single neg point Div" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+void test_bounded_single_neg(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test bounded / single neg point Div" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point,
+    Interval b = MakeInterval(c, "b", IntervalType::Point,
         Negative, BoundType::LowerBound, // lower bound
         Negative, BoundType::UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr bn = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr bn = b.GetLower();
 
     z3::expr emin = halide_div(a1, bn);
     z3::expr emax = halide_div(a0, bn);
@@ -230,25 +233,25 @@ void test_bounded_single_neg() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Div, a, b, e0, e1);
-    check_tightness(c, Operation::Div, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Div, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_lower_bounded_single_neg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test lower bounded / single neg point Div" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+void test_lower_bounded_single_neg(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test lower bounded / single neg point Div" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::Unbounded); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point,
+    Interval b = MakeInterval(c, "b", IntervalType::Point,
         Negative, BoundType::LowerBound, // lower bound
         Negative, BoundType::UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr bn = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr bn = b.GetLower();
 
     z3::expr emin(c); // not used
     z3::expr emax = halide_div(a0, bn);
@@ -256,25 +259,25 @@ void test_lower_bounded_single_neg() {
     Bound e0(NoRestriction, BoundType::Unbounded, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Div, a, b, e0, e1);
-    check_tightness(c, Operation::Div, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Div, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_upper_bounded_single_neg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test upper bounded / single neg point Div" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+void test_upper_bounded_single_neg(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test upper bounded / single neg point Div" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point,
+    Interval b = MakeInterval(c, "b", IntervalType::Point,
         Negative, BoundType::LowerBound, // lower bound
         Negative, BoundType::UpperBound); // upper bound
 
-    z3::expr a1 = a->GetUpper();
-    z3::expr bn = b->GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr bn = b.GetLower();
 
     z3::expr emin = halide_div(a1, bn);
     z3::expr emax(c); // not used
@@ -282,27 +285,27 @@ void test_upper_bounded_single_neg() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::Unbounded, emax);
 
-    check(c, Operation::Div, a, b, e0, e1);
-    check_tightness(c, Operation::Div, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Div, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
 
-void test_bounded_single_point() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test bounded / single (?) point Div" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+void test_bounded_single_point(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test bounded / single (?) point Div" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point, 
+    Interval b = MakeInterval(c, "b", IntervalType::Point, 
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr b0 = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b0 = b.GetLower();
 
     z3::expr emin = ite(b0 > 0, halide_div(a0, b0), halide_div(a1, b0));
     z3::expr emax = ite(b0 > 0, halide_div(a1, b0), halide_div(a0, b0));
@@ -310,24 +313,26 @@ void test_bounded_single_point() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Div, a, b, e0, e1);
-    check_tightness(c, Operation::Div, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Div, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
+} // namespace
 
-int main(int argc, char** argv)
-{
-    test_bounded_pos_unbounded();
-    test_bounded_neg_unbounded();
-    test_point_unbounded();
-    test_bounded_unbounded();
+static RuleGroup rules("div", "div", {"int", "nonlinear"}, {
+    RULE(test_bounded_pos_unbounded),
+    RULE(test_bounded_neg_unbounded),
+    RULE(test_point_unbounded),
+    RULE(test_bounded_unbounded),
     // NONE complete - proven in $ROOT/coq/Interval.v
-    // test_bounded_single_pos();
-    // test_lower_bounded_single_pos();
-    // test_upper_bounded_single_pos();
-    // test_bounded_single_neg();
-    // test_lower_bounded_single_neg();
-    // test_upper_bounded_single_neg();
-    // test_bounded_single_point();
-}
\ No newline at end of file
+    RULE(test_bounded_single_pos, "disabled"),
+    RULE(test_lower_bounded_single_pos, "disabled"),
+    RULE(test_upper_bounded_single_pos, "disabled"),
+    RULE(test_bounded_single_neg, "disabled"),
+    RULE(test_lower_bounded_single_neg, "disabled"),
+    RULE(test_upper_bounded_single_neg, "disabled"),
+    RULE(test_bounded_single_point, "disabled"),
+    RULE(test_single_points, "disabled"),
+});
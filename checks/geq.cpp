@@ -1,8 +1,13 @@
 #include "z3++.h"
 #include <string>
 
+#include "ContextPool.h"
 #include "Interval.h"
 #include "Equality.h"
+#include "Registry.h"
+#include "Report.h"
+
+namespace {
 
 struct GeqPredicate {
     z3::expr equality(z3::expr &i, z3::expr &j) {
@@ -15,24 +20,24 @@ static GeqPredicate GlobalGeqPred;
 
 
 void test_geq_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test bounded >= bounded" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test bounded >= bounded" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::UpperBound);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::UpperBound);
     
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr b0 = b->GetLower();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b0 = b.GetLower();
+    z3::expr b1 = b.GetUpper();
 
     /*
     interval.min = LE::make(b.max, a.min);
@@ -41,27 +46,27 @@ void test_geq_bounded() {
     z3::expr emin = b1 <= a0;
     z3::expr emax = b0 <= a1;
 
-    check_equality_type(a, b, solver, context, emin, emax, GlobalGeqPred);
-    std::cout << "-------------------" << std::endl;
+    report(check_equality_type(a, b, solver, context, emin, emax, GlobalGeqPred));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_upper_bound_geq_lower_bound() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [_, a1] >= [b0, _]" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [_, a1] >= [b0, _]" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
     
-    z3::expr a1 = a->GetUpper();
-    z3::expr b0 = b->GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b0 = b.GetLower();
 
     /*
     interval.max = LE::make(b.min, a.max);
@@ -69,27 +74,27 @@ void test_upper_bound_geq_lower_bound() {
     z3::expr emin = context.bool_val(false);
     z3::expr emax = b0 <= a1;
 
-    check_equality_type(a, b, solver, context, emin, emax, GlobalGeqPred);
-    std::cout << "-------------------" << std::endl;
+    report(check_equality_type(a, b, solver, context, emin, emax, GlobalGeqPred));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_lower_bound_geq_upper_bound() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [a0, _] >= [_, b1]" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [a0, _] >= [_, b1]" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
     
-    z3::expr a0 = a->GetLower();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr b1 = b.GetUpper();
 
     /*
     interval.min = LE::make(b.max, a.min);
@@ -97,12 +102,14 @@ void test_lower_bound_geq_upper_bound() {
     z3::expr emin = b1 <= a0;
     z3::expr emax = context.bool_val(true);
 
-    check_equality_type(a, b, solver, context, emin, emax, GlobalGeqPred);
-    std::cout << "-------------------" << std::endl;
+    report(check_equality_type(a, b, solver, context, emin, emax, GlobalGeqPred));
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(void) {
-    test_geq_bounded();
-    test_upper_bound_geq_lower_bound();
-    test_lower_bound_geq_upper_bound();
-}
\ No newline at end of file
+} // namespace
+
+static RuleGroup rules("geq", "geq", {"int"}, {
+    RULE(test_geq_bounded),
+    RULE(test_upper_bound_geq_lower_bound),
+    RULE(test_lower_bound_geq_upper_bound),
+});
@@ -1,20 +1,25 @@
 #include "Interval.h"
 #include "Check.h"
+#include "ContextPool.h"
+#include "Registry.h"
+#include "Report.h"
+
+namespace {
 
 void test_single_point() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test single point Max" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Point,
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test single point Max" << std::endl;
+    z3::context &c = rule_context();
+    Interval a = MakeInterval(c, "a", IntervalType::Point,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point,
+    Interval b = MakeInterval(c, "b", IntervalType::Point,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
 
     z3::expr emin = max(a0, b0);
     z3::expr emax = max(a0, b0);
@@ -22,27 +27,28 @@ void test_single_point() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Max, a, b, e0, e1);
-    check_tightness(c, Operation::Max, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Max, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_not_point() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test single point Max" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test single point Max" << std::endl;
+    z3::context &c = rule_context();
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(c, "b", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b1 = b.GetUpper();
 
     z3::expr emin = max(a0, b0);
     z3::expr emax = max(a1, b1);
@@ -50,14 +56,16 @@ void test_not_point() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Max, a, b, e0, e1);
-    check_tightness(c, Operation::Max, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Max, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(int argc, char** argv)
-{
+} // namespace
+
+static RuleGroup rules("max", "max", {"int"}, {
     // these should be trivially true
-    test_single_point();
-    test_not_point();
-}
+    RULE(test_single_point),
+    RULE(test_not_point),
+});
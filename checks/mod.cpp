@@ -1,20 +1,25 @@
 #include "Interval.h"
 #include "Check.h"
+#include "ContextPool.h"
+#include "Registry.h"
+#include "Report.h"
+
+namespace {
 
 void test_single_point() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test single point Mod" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Point,
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test single point Mod" << std::endl;
+    z3::context &c = rule_context();
+    Interval a = MakeInterval(c, "a", IntervalType::Point,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point,
+    Interval b = MakeInterval(c, "b", IntervalType::Point,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
 
     z3::expr emin = halide_mod(a0, b0);
     z3::expr emax = halide_mod(a0, b0);
@@ -22,24 +27,25 @@ void test_single_point() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Mod, a, b, e0, e1);
-    check_tightness(c, Operation::Mod, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mod, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_pos_lower_mod_unbounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test pos lower bounded % unbounded Mod" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test pos lower bounded % unbounded Mod" << std::endl;
+    z3::context &c = rule_context();
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NonNegative, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(c, "b", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded, // lower bound
         NoRestriction, BoundType::Unbounded); // upper bound
 
-    z3::expr a1 = a->GetUpper();
+    z3::expr a1 = a.GetUpper();
 
     z3::expr emin = c.int_val(0);
     z3::expr emax = a1; // can't make bigger
@@ -47,24 +53,25 @@ void test_pos_lower_mod_unbounded() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Mod, a, b, e0, e1);
-    check_tightness(c, Operation::Mod, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mod, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_mod_pos_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test <any> % pos bounded Mod" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test <any> % pos bounded Mod" << std::endl;
+    z3::context &c = rule_context();
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(c, "b", IntervalType::Unknown,
         Positive, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    z3::expr b1 = b->GetUpper();
+    z3::expr b1 = b.GetUpper();
 
     z3::expr emin = c.int_val(0);
     z3::expr emax = b1 - 1;
@@ -72,25 +79,26 @@ void test_mod_pos_bounded() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Mod, a, b, e0, e1);
-    check_tightness(c, Operation::Mod, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mod, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_mod_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test <any> % bounded Mod" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown,
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test <any> % bounded Mod" << std::endl;
+    z3::context &c = rule_context();
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(c, "b", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound, // lower bound
         NoRestriction, BoundType::UpperBound); // upper bound
 
-    z3::expr b0 = b->GetLower();
-    z3::expr b1 = b->GetUpper();
+    z3::expr b0 = b.GetLower();
+    z3::expr b1 = b.GetUpper();
 
     z3::expr emin = c.int_val(0);
     z3::expr emax = max(max(c.int_val(0), b1 - 1), -1 - b0);
@@ -98,15 +106,17 @@ void test_mod_bounded() {
     Bound e0(NoRestriction, BoundType::LowerBound, emin);
     Bound e1(NoRestriction, BoundType::UpperBound, emax);
 
-    check(c, Operation::Mod, a, b, e0, e1);
-    check_tightness(c, Operation::Mod, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mod, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(int argc, char** argv)
-{
-    test_single_point();
-    test_pos_lower_mod_unbounded();
-    test_mod_pos_bounded();
-    test_mod_bounded();
-}
+} // namespace
+
+static RuleGroup rules("mod", "mod", {"int", "nonlinear"}, {
+    RULE(test_single_point),
+    RULE(test_pos_lower_mod_unbounded),
+    RULE(test_mod_pos_bounded),
+    RULE(test_mod_bounded),
+});
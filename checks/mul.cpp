@@ -1,20 +1,23 @@
 #include "Interval.h"
 #include "Check.h"
+#include "Registry.h"
+#include "Report.h"
 
-void test_single_point() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test single point Mul" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Point, 
+namespace {
+
+void test_single_point(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test single point Mul" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Point, 
         NoRestriction, LowerBound, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point, 
+    Interval b = MakeInterval(c, "b", IntervalType::Point, 
         NoRestriction, LowerBound, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
 
     z3::expr emin = a0 * b0;
     z3::expr emax = a0 * b0;
@@ -22,20 +25,20 @@ void test_single_point() {
     Bound e0(NoRestriction, LowerBound, emin);
     Bound e1(NoRestriction, UpperBound, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_b_zero() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test b 0 a unbounded Mul" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown, 
+void test_b_zero(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test b 0 a unbounded Mul" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown, 
         NoRestriction, Unbounded, // lower bound
         NoRestriction, Unbounded); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point, 
+    Interval b = MakeInterval(c, "b", IntervalType::Point, 
         IsZero, LowerBound, // lower bound
         IsZero, UpperBound); // upper bound
 
@@ -45,26 +48,26 @@ void test_b_zero() {
     Bound e0(IsZero, LowerBound, emin);
     Bound e1(IsZero, UpperBound, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_b_pos_a_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test b >= 0 a bounded Mul" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown, 
+void test_b_pos_a_bounded(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test b >= 0 a bounded Mul" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown, 
         NoRestriction, LowerBound, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point, 
+    Interval b = MakeInterval(c, "b", IntervalType::Point, 
         NonNegative, LowerBound, // lower bound
         NonNegative, UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr bp = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr bp = b.GetLower();
 
     z3::expr emin = a0 * bp;
     z3::expr emax = a1 * bp;
@@ -72,27 +75,27 @@ void test_b_pos_a_bounded() {
     Bound e0(NoRestriction, LowerBound, emin);
     Bound e1(NoRestriction, UpperBound, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
 
-void test_b_neg_a_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test b <= 0 a bounded Mul" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown, 
+void test_b_neg_a_bounded(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test b <= 0 a bounded Mul" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown, 
         NoRestriction, LowerBound, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point, 
+    Interval b = MakeInterval(c, "b", IntervalType::Point, 
         NonPositive, LowerBound, // lower bound
         NonPositive, UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr bn = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr bn = b.GetLower();
 
     z3::expr emin = a1 * bn;
     z3::expr emax = a0 * bn;
@@ -100,25 +103,25 @@ void test_b_neg_a_bounded() {
     Bound e0(NoRestriction, LowerBound, emin);
     Bound e1(NoRestriction, UpperBound, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_b_pos_a_upperbounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test b >= 0 a upperbounded Mul" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown, 
+void test_b_pos_a_upperbounded(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test b >= 0 a upperbounded Mul" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown, 
         NoRestriction, Unbounded, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point, 
+    Interval b = MakeInterval(c, "b", IntervalType::Point, 
         NonNegative, LowerBound, // lower bound
         NonNegative, UpperBound); // upper bound
 
-    z3::expr a1 = a->GetUpper();
-    z3::expr bp = b->GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr bp = b.GetLower();
 
     z3::expr emin(c); // not used
     z3::expr emax = a1 * bp;
@@ -126,25 +129,25 @@ void test_b_pos_a_upperbounded() {
     Bound e0(NoRestriction, Unbounded, emin);
     Bound e1(NoRestriction, UpperBound, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_b_neg_a_upperbounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test b <= 0 a upperbounded Mul" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown, 
+void test_b_neg_a_upperbounded(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test b <= 0 a upperbounded Mul" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown, 
         NoRestriction, Unbounded, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point, 
+    Interval b = MakeInterval(c, "b", IntervalType::Point, 
         NonPositive, LowerBound, // lower bound
         NonPositive, UpperBound); // upper bound
 
-    z3::expr a1 = a->GetUpper();
-    z3::expr bn = b->GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr bn = b.GetLower();
 
     z3::expr emin = a1 * bn;
     z3::expr emax(c); // not used
@@ -152,26 +155,26 @@ void test_b_neg_a_upperbounded() {
     Bound e0(NoRestriction, LowerBound, emin);
     Bound e1(NoRestriction, Unbounded, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_b_point_a_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test b0 == b1 a bounded Mul" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::Unknown, 
+void test_b_point_a_bounded(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test b0 == b1 a bounded Mul" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::Unknown, 
         NoRestriction, LowerBound, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::Point, 
+    Interval b = MakeInterval(c, "b", IntervalType::Point, 
         NoRestriction, LowerBound, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr bp = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr bp = b.GetLower();
 
     z3::expr emin = z3::ite(bp >= 0, a0 * bp, a1 * bp);
     z3::expr emax = z3::ite(bp >= 0, a1 * bp, a0 * bp);
@@ -179,28 +182,28 @@ void test_b_point_a_bounded() {
     Bound e0(NoRestriction, LowerBound, emin);
     Bound e1(NoRestriction, UpperBound, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
 
-void test_both_bounded() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test both bounded Mul" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::NotPoint,
+void test_both_bounded(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test both bounded Mul" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::NotPoint,
         NoRestriction, LowerBound, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::NotPoint,
+    Interval b = MakeInterval(c, "b", IntervalType::NotPoint,
         NoRestriction, LowerBound, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr b0 = b->GetLower();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b0 = b.GetLower();
+    z3::expr b1 = b.GetUpper();
 
     z3::expr emin = min(min(min(a0 * b0, a0 * b1), a1 * b0), a1 * b1);
     z3::expr emax = max(max(max(a0 * b0, a0 * b1), a1 * b0), a1 * b1);
@@ -208,26 +211,26 @@ void test_both_bounded() {
     Bound e0(NoRestriction, LowerBound, emin);
     Bound e1(NoRestriction, UpperBound, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_positive_with_lower_bound() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test (a0, a1) * (b0, inf) with (a0 >= 0)" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::NotPoint,
+void test_positive_with_lower_bound(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test (a0, a1) * (b0, inf) with (a0 >= 0)" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::NotPoint,
         NonNegative, LowerBound, // lower bound
         NonNegative, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::NotPoint,
+    Interval b = MakeInterval(c, "b", IntervalType::NotPoint,
         NoRestriction, LowerBound, // lower bound
         NoRestriction, Unbounded); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
-    z3::expr a1 = a->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
+    z3::expr a1 = a.GetUpper();
 
     z3::expr emin = min(a0 * b0, a1 * b0);
     z3::expr emax(c); // not used
@@ -235,26 +238,26 @@ void test_positive_with_lower_bound() {
     Bound e0(NoRestriction, LowerBound, emin);
     Bound e1(NoRestriction, Unbounded, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_positive_with_upper_bound() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test (a0, a1) * (-inf, b1) with (a0 >= 0)" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::NotPoint,
+void test_positive_with_upper_bound(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test (a0, a1) * (-inf, b1) with (a0 >= 0)" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::NotPoint,
         NonNegative, LowerBound, // lower bound
         NonNegative, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::NotPoint,
+    Interval b = MakeInterval(c, "b", IntervalType::NotPoint,
         NoRestriction, Unbounded, // lower bound
         NoRestriction, UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b1 = b.GetUpper();
 
     z3::expr emin(c); // not used
     z3::expr emax = max(a1 * b1, a0 * b1);
@@ -262,26 +265,26 @@ void test_positive_with_upper_bound() {
     Bound e0(NoRestriction, Unbounded, emin);
     Bound e1(NoRestriction, UpperBound, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_positive_with_nonneg_lower_bound() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test (a0, a1) * (b0, inf) with (a0, b0 >= 0)" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::NotPoint,
+void test_positive_with_nonneg_lower_bound(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test (a0, a1) * (b0, inf) with (a0, b0 >= 0)" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::NotPoint,
         NonNegative, LowerBound, // lower bound
         NonNegative, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::NotPoint,
+    Interval b = MakeInterval(c, "b", IntervalType::NotPoint,
         NonNegative, LowerBound, // lower bound
         NoRestriction, Unbounded); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
-    z3::expr a1 = a->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
+    z3::expr a1 = a.GetUpper();
 
     z3::expr emin = a0 * b0;
     z3::expr emax(c); // not used
@@ -289,26 +292,26 @@ void test_positive_with_nonneg_lower_bound() {
     Bound e0(NoRestriction, LowerBound, emin);
     Bound e1(NoRestriction, Unbounded, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_positive_with_nonpos_lower_bound() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test (a0, a1) * (b0, inf) with (a0 >= 0 && b0 <= 0)" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::NotPoint,
+void test_positive_with_nonpos_lower_bound(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test (a0, a1) * (b0, inf) with (a0 >= 0 && b0 <= 0)" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::NotPoint,
         NonNegative, LowerBound, // lower bound
         NonNegative, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::NotPoint,
+    Interval b = MakeInterval(c, "b", IntervalType::NotPoint,
         NonPositive, LowerBound, // lower bound
         NoRestriction, Unbounded); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
-    z3::expr a1 = a->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
+    z3::expr a1 = a.GetUpper();
 
     z3::expr emin = a1 * b0;
     z3::expr emax(c); // not used
@@ -316,25 +319,25 @@ void test_positive_with_nonpos_lower_bound() {
     Bound e0(NoRestriction, LowerBound, emin);
     Bound e1(NoRestriction, Unbounded, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_positive_with_nonneg_upper_bound() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test (a0, a1) * (-inf, b1) with (a0, b1 >= 0)" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::NotPoint,
+void test_positive_with_nonneg_upper_bound(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test (a0, a1) * (-inf, b1) with (a0, b1 >= 0)" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::NotPoint,
         NonNegative, LowerBound, // lower bound
         NonNegative, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::NotPoint,
+    Interval b = MakeInterval(c, "b", IntervalType::NotPoint,
         NoRestriction, Unbounded, // lower bound
         NonNegative, UpperBound); // upper bound
 
-    z3::expr a1 = a->GetUpper();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b1 = b.GetUpper();
 
     z3::expr emin(c); // not used
     z3::expr emax = a1 * b1;
@@ -342,26 +345,26 @@ void test_positive_with_nonneg_upper_bound() {
     Bound e0(NoRestriction, Unbounded, emin);
     Bound e1(NoRestriction, UpperBound, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-void test_positive_with_nonpos_upper_bound() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test (a0, a1) * (-inf, b1) with (a0 >= 0 && b1 <= 0)" << std::endl;
-    z3::context c;
-    Interval *a = MakeInterval(c, "a", IntervalType::NotPoint,
+void test_positive_with_nonpos_upper_bound(z3::context &c) {
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test (a0, a1) * (-inf, b1) with (a0 >= 0 && b1 <= 0)" << std::endl;
+    Interval a = MakeInterval(c, "a", IntervalType::NotPoint,
         NonNegative, LowerBound, // lower bound
         NonNegative, UpperBound); // upper bound
 
-    Interval *b = MakeInterval(c, "b", IntervalType::NotPoint,
+    Interval b = MakeInterval(c, "b", IntervalType::NotPoint,
         NoRestriction, Unbounded, // lower bound
         NonPositive, UpperBound); // upper bound
 
-    z3::expr a0 = a->GetLower();
-    z3::expr a1 = a->GetUpper();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a0 = a.GetLower();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b1 = b.GetUpper();
 
     z3::expr emin(c); // not used
     z3::expr emax = a0 * b1;
@@ -369,24 +372,27 @@ void test_positive_with_nonpos_upper_bound() {
     Bound e0(NoRestriction, Unbounded, emin);
     Bound e1(NoRestriction, UpperBound, emax);
 
-    check(c, Operation::Mul, a, b, e0, e1);
-    check_tightness(c, Operation::Mul, a, b, e0, e1);
-    std::cout << "-------------------" << std::endl;
+    Session session(c, Operation::Mul, a, b);
+    report(session.Check(e0, e1));
+    report(session.CheckTightness(e0, e1));
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(int argc, char** argv) {
-    test_single_point();
-    test_b_zero();
-    test_b_pos_a_bounded();
-    test_b_neg_a_bounded();
-    test_b_pos_a_upperbounded();
-    test_b_neg_a_upperbounded();
-    test_b_point_a_bounded();
-    test_both_bounded();
-    test_positive_with_lower_bound();
-    test_positive_with_upper_bound();
-    test_positive_with_nonneg_lower_bound();
-    test_positive_with_nonpos_lower_bound();
-    test_positive_with_nonneg_upper_bound();
-    test_positive_with_nonpos_upper_bound();
-}
+} // namespace
+
+static RuleGroup rules("mul", "mul", {"int", "nonlinear"}, {
+    RULE(test_single_point),
+    RULE(test_b_zero),
+    RULE(test_b_pos_a_bounded),
+    RULE(test_b_neg_a_bounded),
+    RULE(test_b_pos_a_upperbounded),
+    RULE(test_b_neg_a_upperbounded),
+    RULE(test_b_point_a_bounded),
+    RULE(test_both_bounded),
+    RULE(test_positive_with_lower_bound),
+    RULE(test_positive_with_upper_bound),
+    RULE(test_positive_with_nonneg_lower_bound),
+    RULE(test_positive_with_nonpos_lower_bound),
+    RULE(test_positive_with_nonneg_upper_bound),
+    RULE(test_positive_with_nonpos_upper_bound),
+});
@@ -1,8 +1,13 @@
+#include "ContextPool.h"
 #include "Interval.h"
+#include "Registry.h"
+#include "Report.h"
 
-void check_select(Bool_Interval cond, Interval *a, Interval *b, z3::solver &solver, z3::context &context, z3::expr &bound, bool isMin) {
-    z3::expr i = context.int_const("i");
-    z3::expr j = context.int_const("j");
+namespace {
+
+CheckResult check_select(Bool_Interval cond, const Interval &a, const Interval &b, z3::solver &solver, z3::context &context, z3::expr &bound, bool isMin) {
+    z3::expr i = int_symbol(context, "i");
+    z3::expr j = int_symbol(context, "j");
     apply_interval(solver, a, i);
     apply_interval(solver, b, j);
 
@@ -14,79 +19,70 @@ void check_select(Bool_Interval cond, Interval *a, Interval *b, z3::solver &solv
         solver.add(res > bound);
     }
 
-    z3::check_result ans = solver.check();
-    if(ans == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (ans == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        std::cout << "Resultant bounds: [";
+    CheckResult result = solve(solver, [=](std::ostream &out, z3::model &model) {
+        out << "Resultant bounds: [";
         if (isMin) {
-            std::cout << model.eval(bound) << ", _";
+            out << model.eval(bound) << ", _";
         } else {
-            std::cout << "_, " << model.eval(bound);
+            out << "_, " << model.eval(bound);
         }
-        std::cout << "]" << std::endl;
-
-        std::cout << "Contradiction: select(";
-        std::cout << model.eval(cond.inner) << ", ";
-        std::cout << model.eval(i) << ", ";
-        std::cout << model.eval(j) << ")";
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
-    std::cout << "-------------------" << std::endl;
-    delete a;
-    delete b;
+        out << "]" << std::endl;
+
+        out << "Contradiction: select(";
+        out << model.eval(cond.inner) << ", ";
+        out << model.eval(i) << ", ";
+        out << model.eval(j) << ")";
+        out << " = " << model.eval(res) << std::endl;
+    });
+    return result;
 }
 
 void test_select_min_lower_equal() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test select's min a.min.same_as(b.min)" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test select's min a.min.same_as(b.min)" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval cond("cond", context, solver);
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
     
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
 
     // a.min.same_as(b.min)
     solver.add(a0 == b0);
 
     z3::expr emin = a0;
     
-    check_select(cond, a, b, solver, context, emin, true);
+    report(check_select(cond, a, b, solver, context, emin, true));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_select_min_cond_single_point() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test select's min cond.is_single_point()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test select's min cond.is_single_point()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval cond("cond", context, solver);
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
     
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
 
     // cond.is_single_point()
     solver.add(cond.lower == cond.upper);
@@ -96,27 +92,28 @@ void test_select_min_cond_single_point() {
     */
     z3::expr emin = ite(cond.lower, a0, b0);
     
-    check_select(cond, a, b, solver, context, emin, true);
+    report(check_select(cond, a, b, solver, context, emin, true));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_select_min_cond_known_all() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test select's min is_zero(cond.min) && is_one(cond.max)" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test select's min is_zero(cond.min) && is_one(cond.max)" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval cond("cond", context, solver);
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
     
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
 
     // is_zero(cond.min) && is_one(cond.max)
     solver.add(!cond.lower && cond.upper);
@@ -124,27 +121,28 @@ void test_select_min_cond_known_all() {
     // interval.min = Interval::make_min(a.min, b.min);
     z3::expr emin = ite(a0 < b0, a0, b0);
     
-    check_select(cond, a, b, solver, context, emin, true);
+    report(check_select(cond, a, b, solver, context, emin, true));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_select_min_cond_upper_true() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test select's min is_one(cond.max)" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test select's min is_one(cond.max)" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval cond("cond", context, solver);
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
     
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
 
     // is_one(cond.max)
     solver.add(cond.upper);
@@ -158,27 +156,28 @@ void test_select_min_cond_upper_true() {
     z3::expr temp = ite(cond.lower, a0, b0);
     z3::expr emin = ite(temp < a0, temp, a0);
     
-    check_select(cond, a, b, solver, context, emin, true);
+    report(check_select(cond, a, b, solver, context, emin, true));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_select_min_cond_lower_false() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test select's min is_zero(cond.min)" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test select's min is_zero(cond.min)" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval cond("cond", context, solver);
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
     
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
 
     // is_zero(cond.min)
     solver.add(!cond.lower);
@@ -192,27 +191,28 @@ void test_select_min_cond_lower_false() {
     z3::expr temp = ite(cond.upper, a0, b0);
     z3::expr emin = ite(temp < b0, temp, b0);
     
-    check_select(cond, a, b, solver, context, emin, true);
+    report(check_select(cond, a, b, solver, context, emin, true));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_select_min_cond_unknown() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test select's min else{}" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test select's min else{}" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval cond("cond", context, solver);
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::LowerBound,
         NoRestriction, BoundType::Unbounded);
     
-    z3::expr a0 = a->GetLower();
-    z3::expr b0 = b->GetLower();
+    z3::expr a0 = a.GetLower();
+    z3::expr b0 = b.GetLower();
 
     /*
     string a_var_name = unique_name('t'), b_var_name = unique_name('t');
@@ -227,27 +227,28 @@ void test_select_min_cond_unknown() {
     z3::expr op_min = ite(cond.lower, a0, b0);
     z3::expr emin = ite(op_min < op_max, op_min, op_max);
     
-    check_select(cond, a, b, solver, context, emin, true);
+    report(check_select(cond, a, b, solver, context, emin, true));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_select_max_upper_equal() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test select's max a.max.same_as(b.max)" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test select's max a.max.same_as(b.max)" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval cond("cond", context, solver);
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
     
-    z3::expr a1 = a->GetUpper();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b1 = b.GetUpper();
 
     // a.max.same_as(b.max)
     solver.add(a1 == b1);
@@ -257,27 +258,28 @@ void test_select_max_upper_equal() {
     */
     z3::expr emax = a1;
     
-    check_select(cond, a, b, solver, context, emax, false);
+    report(check_select(cond, a, b, solver, context, emax, false));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_select_max_cond_single_point() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test select's max cond.is_single_point()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test select's max cond.is_single_point()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval cond("cond", context, solver);
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
     
-    z3::expr a1 = a->GetUpper();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b1 = b.GetUpper();
 
     // cond.is_single_point()
     solver.add(cond.lower == cond.upper);
@@ -287,27 +289,28 @@ void test_select_max_cond_single_point() {
     */
     z3::expr emax = ite(cond.lower, a1, b1);
     
-    check_select(cond, a, b, solver, context, emax, false);
+    report(check_select(cond, a, b, solver, context, emax, false));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_select_max_cond_known_all() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test select's max is_zero(cond.min) && is_one(cond.max)" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test select's max is_zero(cond.min) && is_one(cond.max)" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval cond("cond", context, solver);
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
     
-    z3::expr a1 = a->GetUpper();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b1 = b.GetUpper();
 
     // is_zero(cond.min) && is_one(cond.max)
     solver.add(!cond.lower && cond.upper);
@@ -317,27 +320,28 @@ void test_select_max_cond_known_all() {
     */
     z3::expr emax = ite(a1 > b1, a1, b1);
     
-    check_select(cond, a, b, solver, context, emax, false);
+    report(check_select(cond, a, b, solver, context, emax, false));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_select_max_cond_upper_true() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test select's max is_one(cond.max)" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test select's max is_one(cond.max)" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval cond("cond", context, solver);
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
     
-    z3::expr a1 = a->GetUpper();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b1 = b.GetUpper();
 
     // is_one(cond.max)
     solver.add(cond.upper);
@@ -351,27 +355,28 @@ void test_select_max_cond_upper_true() {
     z3::expr temp = ite(cond.lower, a1, b1);
     z3::expr emax = ite(temp > a1, temp, a1);
     
-    check_select(cond, a, b, solver, context, emax, false);
+    report(check_select(cond, a, b, solver, context, emax, false));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_select_max_cond_lower_false() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test select's max is_zero(cond.min)" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test select's max is_zero(cond.min)" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval cond("cond", context, solver);
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
     
-    z3::expr a1 = a->GetUpper();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b1 = b.GetUpper();
 
     // is_zero(cond.min)
     solver.add(!cond.lower);
@@ -385,27 +390,28 @@ void test_select_max_cond_lower_false() {
     z3::expr temp = ite(cond.upper, a1, b1);
     z3::expr emax = ite(temp > b1, temp, b1);
     
-    check_select(cond, a, b, solver, context, emax, false);
+    report(check_select(cond, a, b, solver, context, emax, false));
+    rule_output() << "-------------------" << std::endl;
 }
 
 void test_select_max_cond_unknown() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test select's max else{}" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test select's max else{}" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
 
     Bool_Interval cond("cond", context, solver);
-    Interval *a = MakeInterval(context, "a", IntervalType::Unknown,
+    Interval a = MakeInterval(context, "a", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
 
-    Interval *b = MakeInterval(context, "b", IntervalType::Unknown,
+    Interval b = MakeInterval(context, "b", IntervalType::Unknown,
         NoRestriction, BoundType::Unbounded,
         NoRestriction, BoundType::UpperBound);
     
-    z3::expr a1 = a->GetUpper();
-    z3::expr b1 = b->GetUpper();
+    z3::expr a1 = a.GetUpper();
+    z3::expr b1 = b.GetUpper();
 
     /*
     string a_var_name = unique_name('t'), b_var_name = unique_name('t');
@@ -420,20 +426,23 @@ void test_select_max_cond_unknown() {
     z3::expr op_min = ite(cond.lower, a1, b1);
     z3::expr emax = ite(op_min > op_max, op_min, op_max);
     
-    check_select(cond, a, b, solver, context, emax, false);
+    report(check_select(cond, a, b, solver, context, emax, false));
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(void) {
-    test_select_min_lower_equal();
-    test_select_min_cond_single_point();
-    test_select_min_cond_known_all();
-    test_select_min_cond_upper_true();
-    test_select_min_cond_lower_false();
-    test_select_min_cond_unknown();
-    test_select_max_upper_equal();
-    test_select_max_cond_single_point();
-    test_select_max_cond_known_all();
-    test_select_max_cond_upper_true();
-    test_select_max_cond_lower_false();
-    test_select_max_cond_unknown();
-}
\ No newline at end of file
+} // namespace
+
+static RuleGroup rules("select", "select", {"int"}, {
+    RULE(test_select_min_lower_equal),
+    RULE(test_select_min_cond_single_point),
+    RULE(test_select_min_cond_known_all),
+    RULE(test_select_min_cond_upper_true),
+    RULE(test_select_min_cond_lower_false),
+    RULE(test_select_min_cond_unknown),
+    RULE(test_select_max_upper_equal),
+    RULE(test_select_max_cond_single_point),
+    RULE(test_select_max_cond_known_all),
+    RULE(test_select_max_cond_upper_true),
+    RULE(test_select_max_cond_lower_false),
+    RULE(test_select_max_cond_unknown),
+});
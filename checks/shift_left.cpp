@@ -1,161 +1,80 @@
-#include "Interval.h"
+#include "BVInterval.h"
 #include "Check.h"
+#include "ContextPool.h"
+#include "Exhaustive.h"
 #include "Operations.h"
+#include "Overflow.h"
+#include "Registry.h"
+#include "Report.h"
 
-#define NBITS 8
-
-// TODO: need framework for doing bv intervals
-
+namespace {
 
 // don't let i << j overflow
 void disallow_overflow(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool iIsUint, bool jIsUint, z3::solver &solver) {
-    z3::expr jpos = (jIsUint || (j >= 0));
-    z3::expr pos_bit_count = (count_set_bits(i, NBITS) != count_set_bits(res, NBITS)) && (iIsUint || (i >= 0));
-    z3::expr i_sign_mask = z3::ashr((i & (1 << (NBITS-1))), NBITS);
-    z3::expr j_sign_mask = z3::ashr((j & (1 << (NBITS-1))), NBITS);
-    z3::expr extend_i = concat(i_sign_mask, i);
-    z3::expr extend_j = concat(j_sign_mask, j);
-    uint32_t mask = 0xffffffff >> (32 - (NBITS)); // mask of NBITS 1s, which is INT_MIN for NBITS
-    z3::expr int_min = i.ctx().bv_val(mask, NBITS * 2);
-    z3::expr neg_overflow = (iIsUint) ? (i.ctx().bool_val(false)) : (left_shift(extend_i, extend_j, iIsUint, jIsUint) < int_min);
-    // sign change on an integer is overflow, the false can be optimized out
-    z3::expr sign_change = (iIsUint) ? (i.ctx().bool_val(false)) : ((i > 0) && res < 0);
-    solver.add(!(jpos && (pos_bit_count || sign_change || neg_overflow)));
+    solver.add(!left_shift_overflows(i, j, res, iIsUint, jIsUint));
 }
 
-void check_shift_left(bool isUpperBound, const z3::expr &a_bound, const z3::expr &b_bound,
-                        bool aIsUint, bool bIsUint, const z3::expr &bound, z3::solver &solver, z3::context &context) {
-
-    const z3::expr zero = context.bv_val(0x0ull, NBITS);
-    z3::expr i = context.bv_const("i", NBITS);
-    z3::expr j = context.bv_const("j", NBITS);
-    solver.add(j < NBITS); // otherwise UB
-
-    if (isUpperBound) {
-        if (!aIsUint) {
-            solver.add(i <= a_bound);
-        } else {
-            solver.add(z3::ule(i, a_bound));
-        }
-        if (!bIsUint) {
-            solver.add(j <= b_bound);
-        } else {
-            solver.add(z3::ule(j, b_bound));
-        }
-    } else {
-        if (!aIsUint) {
-            solver.add(i >= a_bound);
-        } else {
-            solver.add(z3::uge(i, a_bound));
-        }
-        if (!bIsUint) {
-            solver.add(j >= b_bound);
-        } else {
-            solver.add(z3::uge(j, b_bound));
-        }
-    }
-
-    z3::expr res(context);
-    if (aIsUint && bIsUint) {
-        res = uint_shift_left(i, j);
-    } else if (!aIsUint && bIsUint) {
-        res = iu_shift_left(i, j);
-    } else if (aIsUint && !bIsUint) {
-        res = ui_shift_left(i, j);
-    } else {
-        // !aIsUint && !bIsUint
-        res = int_shift_left(i, j);
-    }
-
-    disallow_overflow(i, j, res, aIsUint, bIsUint, solver);
-
-    if (isUpperBound) {
-        // if possible to be more than our max, that's bad
-        if (!aIsUint) {
-            solver.add(res > bound);
-        } else {
-            solver.add(z3::ugt(res, bound));
-        }
-    } else {
-        // if possible to be less than our min, that's bad
-        if (!aIsUint) {
-            solver.add(res < bound);
-        } else {
-            solver.add(z3::ult(res, bound));
-        }
-    }
-    
-    z3::check_result ans = solver.check();
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        if (isUpperBound) {
-            std::cout << "[_, " << model.eval(a_bound) << "] << ";
-            std::cout << "[_, " << model.eval(b_bound) << "]" << std::endl;
-            std::cout << "Resultant bounds: [_, " << model.eval(bound) << "]" << std::endl;
-        } else {
-            std::cout << "[" << model.eval(a_bound) << ", _] << ";
-            std::cout << "[" << model.eval(b_bound) << ", _]" << std::endl;
-            std::cout << "Resultant bounds: [" << model.eval(bound) << ", _]" << std::endl;
-        }
-
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(i);
-        std::cout << " << ";
-        std::cout << model.eval(j);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
+// a << b, the result has the type of a
+template<unsigned Width, bool ASigned, bool BSigned>
+CheckResult check_shift_left(z3::solver &solver, const BVInterval<Width, ASigned> &a,
+                                const BVInterval<Width, BSigned> &b, const BVInterval<Width, ASigned> &result) {
+    z3::context &context = solver.ctx();
+    z3::expr i = bv_symbol(context, "i", Width);
+    z3::expr j = bv_symbol(context, "j", Width);
+    solver.add(j < Width); // otherwise UB
+
+    z3::expr res = left_shift(i, j, !ASigned, !BSigned);
+    disallow_overflow(i, j, res, !ASigned, !BSigned, solver);
+
+    return check_bv(solver, "<<", a, i, b, j, res, result);
 }
 
+template<unsigned Width>
 void test_lower_bound_lshift_nonneg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [a0, _] << u[b0, _] && b0 >= 0 && b0 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [a0, _] << u[b0, _] && b0 >= 0 && b0 < t.bits()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr b0 = Int::Variable(context, "b0");
     // b is unsigned because strictly non-neg
     solver.add(z3::uge(b0, 0));
-    solver.add(z3::ult(b0, NBITS));
-    bool aIsUint = false;
-    bool bIsUint = true;
+    solver.add(z3::ult(b0, Width));
 
     // interval.min = a_interval.min << b_interval.min;
     z3::expr emin = iu_shift_left(a0, b0);
-    disallow_overflow(a0, b0, emin, aIsUint, bIsUint, solver);
+    disallow_overflow(a0, b0, emin, /* aIsUint */false, /* bIsUint */true, solver);
 
-    check_shift_left(false, a0, b0, aIsUint, bIsUint, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(solver, Int(a0, std::nullopt), UInt(b0, std::nullopt), Int(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_uint_lower_bound_lshift_nonneg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[a0, _] << u[b0, _] && b0 >= 0 && b0 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[a0, _] << u[b0, _] && b0 >= 0 && b0 < t.bits()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr b0 = Int::Variable(context, "b0");
     // b is unsigned because strictly non-neg
     solver.add(z3::uge(b0, 0));
-    solver.add(z3::ult(b0, NBITS));
-    bool aIsUint = true;
-    bool bIsUint = true;
+    solver.add(z3::ult(b0, Width));
 
     // interval.min = a_interval.min << b_interval.min;
     z3::expr emin = uint_shift_left(a0, b0);
     // overflow is not UB for uints
 
-    check_shift_left(false, a0, b0, aIsUint, bIsUint, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(solver, UInt(a0, std::nullopt), UInt(b0, std::nullopt), UInt(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
 /*
@@ -167,186 +86,258 @@ else if (a_interval.has_lower_bound() &&
     interval.min = a_interval.min >> abs(b_interval.min);
 }
 */
+template<unsigned Width>
 void test_nonneg_lower_bound_lshift_neg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [a0(+), _] << [b0, _] && b0 < 0 && b0 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [a0(+), _] << [b0, _] && b0 < 0 && b0 > -t.bits()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    bool aIsUint = false;
-    bool bIsUint = false;
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr b0 = Int::Variable(context, "b0");
 
     solver.add(a0 >= 0);
 
     // can_prove(b_interval.min < 0 && b_interval.min > -t.bits()))
     solver.add(b0 < 0);
-    solver.add(b0 > -NBITS);
+    solver.add(b0 > -(int)Width);
 
     // interval.min = a_interval.min >> abs(b_interval.min);
     z3::expr emin = z3::ashr(a0, b0 * -1);
     // overflow not possible with right shift
 
-    check_shift_left(false, a0, b0, aIsUint, bIsUint, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(solver, Int(a0, std::nullopt), Int(b0, std::nullopt), Int(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_uint_lower_bound_lshift_neg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[a0, _] << [b0, _] && b0 < 0 && b0 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[a0, _] << [b0, _] && b0 < 0 && b0 > -t.bits()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    bool aIsUint = false;
-    bool bIsUint = false;
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr b0 = Int::Variable(context, "b0");
 
     solver.add(a0 >= 0);
 
     // can_prove(b_interval.min < 0 && b_interval.min > -t.bits()))
     solver.add(b0 < 0);
-    solver.add(b0 > -NBITS);
+    solver.add(b0 > -(int)Width);
 
     // interval.min = a_interval.min >> abs(b_interval.min);
     z3::expr emin = z3::ashr(a0, b0 * -1);
     // overflow not possible with right shift
 
-    check_shift_left(false, a0, b0, aIsUint, bIsUint, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(solver, Int(a0, std::nullopt), Int(b0, std::nullopt), Int(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_neg_lower_bound_lshift_neg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [a0(-), _] << [b0, _] && b0 < 0 && b0 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [a0(-), _] << [b0, _] && b0 < 0 && b0 > -t.bits()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    bool aIsUint = false;
-    bool bIsUint = false;
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr b0 = Int::Variable(context, "b0");
 
     solver.add(a0 >= 0);
 
     // can_prove(b_interval.min < 0 && b_interval.min > -t.bits()))
     solver.add(b0 < 0);
-    solver.add(b0 > -NBITS);
+    solver.add(b0 > -(int)Width);
 
     // interval.min = a_interval.min >> abs(b_interval.min);
     z3::expr emin = z3::ashr(a0, b0 * -1);
     // overflow not possible with right shift
 
-    check_shift_left(false, a0, b0, aIsUint, bIsUint, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(solver, Int(a0, std::nullopt), Int(b0, std::nullopt), Int(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
 
+template<unsigned Width>
 void test_upper_bound_lshift_nonneg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [_, a1] << u[_, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [_, a1] << u[_, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a1 = Int::Variable(context, "a1");
+    z3::expr b1 = Int::Variable(context, "b1");
     // b1 >= 0 && b1 < t.bits()
     solver.add(z3::uge(b1, 0));
-    solver.add(z3::ult(b1, NBITS));
-    bool aIsUint = false;
-    bool bIsUint = true;
+    solver.add(z3::ult(b1, Width));
 
     // interval.max = a_interval.max << b_interval.max;
     z3::expr emax = z3::shl(a1, b1);       // lower bound
-    disallow_overflow(a1, b1, emax, aIsUint, bIsUint, solver);
+    disallow_overflow(a1, b1, emax, /* aIsUint */false, /* bIsUint */true, solver);
 
-    check_shift_left(true, a1, b1, aIsUint, bIsUint, emax, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(solver, Int(std::nullopt, a1), UInt(std::nullopt, b1), Int(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_uint_upper_bound_lshift_nonneg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[_, a1] << u[_, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[_, a1] << u[_, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a1 = Int::Variable(context, "a1");
+    z3::expr b1 = Int::Variable(context, "b1");
     // b1 >= 0 && b1 < t.bits()
     solver.add(z3::uge(b1, 0));
-    solver.add(z3::ult(b1, NBITS));
-    bool aIsUint = true;
-    bool bIsUint = true;
+    solver.add(z3::ult(b1, Width));
 
     // interval.max = a_interval.max << b_interval.max;
     z3::expr emax = z3::shl(a1, b1);       // lower bound
-    disallow_overflow(a1, b1, emax, aIsUint, bIsUint, solver);
+    disallow_overflow(a1, b1, emax, /* aIsUint */true, /* bIsUint */true, solver);
 
-    check_shift_left(true, a1, b1, aIsUint, bIsUint, emax, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(solver, UInt(std::nullopt, a1), UInt(std::nullopt, b1), UInt(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_upper_bound_lshift_neg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [_, a1] << [_, b1] && b1 < 0 && b1 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [_, a1] << [_, b1] && b1 < 0 && b1 > -t.bits()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a1 = Int::Variable(context, "a1");
+    z3::expr b1 = Int::Variable(context, "b1");
     // b1 < 0 && b1 > -t.bits()
     solver.add(b1 < 0);
-    solver.add(b1 > -NBITS);
-    bool aIsUint = false;
-    bool bIsUint = false;
+    solver.add(b1 > -(int)Width);
 
     // interval.max = a_interval.max >> abs(b_interval.max);
     z3::expr emax = z3::lshr(a1, b1 * -1);       // lower bound
     // impossible to overflow with right shift
 
-    check_shift_left(true, a1, b1, aIsUint, bIsUint, emax, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(solver, Int(std::nullopt, a1), Int(std::nullopt, b1), Int(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_uint_upper_bound_lshift_neg() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[_, a1] << [_, b1] && b1 < 0 && b1 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[_, a1] << [_, b1] && b1 < 0 && b1 > -t.bits()" << std::endl;
     
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a1 = Int::Variable(context, "a1");
+    z3::expr b1 = Int::Variable(context, "b1");
     // b1 < 0 && b1 > -t.bits()
     solver.add(b1 < 0);
-    solver.add(b1 > -NBITS);
-    bool aIsUint = true;
-    bool bIsUint = false;
+    solver.add(b1 > -(int)Width);
 
     // interval.max = a_interval.max >> abs(b_interval.max);
     z3::expr emax = z3::lshr(a1, b1 * -1);       // lower bound
     // impossible to overflow with right shift
 
-    check_shift_left(true, a1, b1, aIsUint, bIsUint, emax, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_left(solver, UInt(std::nullopt, a1), Int(std::nullopt, b1), UInt(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(int argc, char** argv) {
-    test_lower_bound_lshift_nonneg();
-    test_nonneg_lower_bound_lshift_neg();
-    test_neg_lower_bound_lshift_neg();
-    test_upper_bound_lshift_nonneg();
-    test_upper_bound_lshift_neg();
+} // namespace
 
-    test_uint_lower_bound_lshift_nonneg();
+static RuleGroup rules("shift_left", "shift_left", {"bv"}, {
+    BV_RULE(test_lower_bound_lshift_nonneg, 8),
+    BV_RULE(test_nonneg_lower_bound_lshift_neg, 8),
+    BV_RULE(test_neg_lower_bound_lshift_neg, 8),
+    BV_RULE(test_upper_bound_lshift_nonneg, 8),
+    BV_RULE(test_upper_bound_lshift_neg, 8),
+    BV_RULE(test_uint_lower_bound_lshift_nonneg, 8),
     // uint version for test_neg_lower_bound_lshift_neg() is not possible (no neg uints)
-    test_uint_upper_bound_lshift_nonneg();
-    test_uint_upper_bound_lshift_neg();
-}
\ No newline at end of file
+    BV_RULE(test_uint_upper_bound_lshift_nonneg, 8),
+    BV_RULE(test_uint_upper_bound_lshift_neg, 8),
+});
+
+// the same rules at 8 bits, for --exhaustive
+static ExhaustiveGroup exhaustive("shift_left", {
+    {"lower_bound_lshift_nonneg", {true, LowerEnd, false, LowerEnd, shift_left8<true, false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 >= 8) {
+                return false;
+            }
+            lo = left_shift8(a0, b0, false, true);
+            return !left_shift_overflows8(a0, b0, lo, false, true);
+        }, LowerEnd, "<<"}},
+    {"nonneg_lower_bound_lshift_neg", {true, LowerEnd, true, LowerEnd, shift_left8<true, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (a0 < 0 || b0 >= 0 || b0 <= -8) {
+                return false;
+            }
+            lo = value8(ashr8(a0, -b0), true);
+            return true;
+        }, LowerEnd, "<<"}},
+    {"neg_lower_bound_lshift_neg", {true, LowerEnd, true, LowerEnd, shift_left8<true, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (a0 < 0 || b0 >= 0 || b0 <= -8) {
+                return false;
+            }
+            lo = value8(ashr8(a0, -b0), true);
+            return true;
+        }, LowerEnd, "<<"}},
+    {"upper_bound_lshift_nonneg", {true, UpperEnd, false, UpperEnd, shift_left8<true, false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b1 >= 8) {
+                return false;
+            }
+            hi = value8(shl8(a1, b1), true);
+            return !left_shift_overflows8(a1, b1, hi, false, true);
+        }, UpperEnd, "<<"}},
+    {"upper_bound_lshift_neg", {true, UpperEnd, true, UpperEnd, shift_left8<true, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b1 >= 0 || b1 <= -8) {
+                return false;
+            }
+            hi = value8(lshr8(a1, -b1), true);
+            return true;
+        }, UpperEnd, "<<"}},
+    {"uint_lower_bound_lshift_nonneg", {false, LowerEnd, false, LowerEnd, shift_left8<false, false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 >= 8) {
+                return false;
+            }
+            lo = value8(shl8(a0, b0), false);
+            return true;
+        }, LowerEnd, "<<"}},
+    {"uint_upper_bound_lshift_nonneg", {false, UpperEnd, false, UpperEnd, shift_left8<false, false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b1 >= 8) {
+                return false;
+            }
+            hi = value8(shl8(a1, b1), false);
+            return !left_shift_overflows8(a1, b1, hi, true, true);
+        }, UpperEnd, "<<"}},
+    {"uint_upper_bound_lshift_neg", {false, UpperEnd, true, UpperEnd, shift_left8<false, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b1 >= 0 || b1 <= -8) {
+                return false;
+            }
+            hi = value8(lshr8(a1, -b1), false);
+            return true;
+        }, UpperEnd, "<<"}},
+});
@@ -1,126 +1,43 @@
-#include "Interval.h"
+#include <algorithm>
+
+#include "BVInterval.h"
 #include "Check.h"
+#include "ContextPool.h"
+#include "Exhaustive.h"
 #include "Operations.h"
+#include "Overflow.h"
+#include "Registry.h"
+#include "Report.h"
 
-#define NBITS 8
-// TODO: need framework for doing bv intervals
-
+namespace {
 
 // no overflow for i >> j
 void disallow_overflow(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool aIsUint, z3::solver &solver) {
-    z3::expr jneg = (j < 0);
-    z3::expr bad_bit_count = (count_set_bits(i, NBITS) != count_set_bits(res, NBITS));
-    // sign change on an integer is overflow, the false can be optimized out
-    z3::expr sign_change = (aIsUint) ? (i.ctx().bool_val(false)) : ((i > 0) && res < 0);
-    // overflow only UB for Int(32) and Int(64)
-    solver.add(!(!aIsUint && jneg && (bad_bit_count || sign_change)));
+    solver.add(!right_shift_overflows(i, j, res, aIsUint));
 }
 
-void check_shift_right(ShiftParams &a_params, ShiftParams &b_params, bool isUpperBounded, bool isUint,
-                        const z3::expr &bound, z3::solver &solver, z3::context &context) {
-    
-    const z3::expr zero = context.bv_val(0x0ull, NBITS);
-
-    z3::expr i = context.bv_const("i", NBITS);
-    z3::expr j = context.bv_const("j", NBITS);
-    if (b_params.isUint) {
-        solver.add(z3::ult(j, NBITS));
+// a >> b, the result has the type of a
+template<unsigned Width, bool ASigned, bool BSigned>
+CheckResult check_shift_right(z3::solver &solver, const BVInterval<Width, ASigned> &a,
+                                const BVInterval<Width, BSigned> &b, const BVInterval<Width, ASigned> &result) {
+    z3::context &context = solver.ctx();
+    z3::expr i = bv_symbol(context, "i", Width);
+    z3::expr j = bv_symbol(context, "j", Width);
+    if (!BSigned) {
+        solver.add(z3::ult(j, Width));
     } else {
-        solver.add(j < NBITS);
-        solver.add(j > -NBITS);
+        solver.add(j < Width);
+        solver.add(j > -(int)Width);
     }
 
-    apply_shift_params(i, solver, a_params);
-    apply_shift_params(j, solver, b_params);
-
-    z3::expr res(context);
-    if (a_params.isUint && b_params.isUint) {
-        res = uint_shift_right(i, j);
-    } else if (!a_params.isUint && b_params.isUint) {
-        res = mixed_iu_shift_right(i, j);
-    } else if (a_params.isUint && !b_params.isUint) {
-        res = mixed_ui_shift_right(i, j);
-    } else {
-        // !a_params.isUint && !b_params.isUint
-        res = int_shift_right(i, j);
-    }
+    z3::expr res = right_shift(i, j, !ASigned, !BSigned);
 
     // disallow overflow if b can be negative
-    if(!b_params.isUint) {
-        disallow_overflow(i, j, res, /* aIsUint */a_params.isUint, solver);
+    if (BSigned) {
+        disallow_overflow(i, j, res, /* aIsUint */!ASigned, solver);
     }
 
-    // check if possible for result to be out of range
-    if (isUpperBounded) {
-        if (isUint) {
-            solver.add(z3::ugt(res, bound));
-        } else {
-            solver.add(res > bound);
-        }
-    } else {
-        if (isUint) {
-            solver.add(z3::ult(res, bound));
-        } else {
-            solver.add(res < bound);
-        }
-    }
-
-    z3::check_result ans = solver.check();
-    if (ans == z3::unsat) {
-        // std::cout << solver.to_smt2() << std::endl;
-        std::cout << "proved" << std::endl;
-    } else if(ans == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else {
-        // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-        std::cout << model << std::endl;
-
-        // print a
-        std::cout << "[";
-        if (a_params.isLowerBounded) {
-            std::cout << model.eval(a_params.lower);
-        } else {
-            std::cout << "_";
-        }
-        std::cout << ", ";
-        if (a_params.isUpperBounded) {
-            std::cout << model.eval(a_params.upper);
-        } else {
-            std::cout << "_";
-        }
-
-        std::cout << "] >> [";
-
-        // print b
-        if (b_params.isLowerBounded) {
-            std::cout << model.eval(b_params.lower);
-        } else {
-            std::cout << "_";
-        }
-        std::cout << ", ";
-        if (b_params.isUpperBounded) {
-            std::cout << model.eval(b_params.upper);
-        } else {
-            std::cout << "_";
-        }
-        
-        std::cout << "] = ";
-
-        // print calculated bounds
-        if (isUpperBounded) {
-            std::cout << "[_, " << model.eval(bound) << "]" << std::endl;
-        } else {
-            std::cout << "[" << model.eval(bound) << ", _]" << std::endl;
-        }
-
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(i);
-        std::cout << " >> ";
-        std::cout << model.eval(j);
-        std::cout << " = " << model.eval(res) << std::endl;
-    }
+    return check_bv(solver, ">>", a, i, b, j, res, result);
 }
 
 /*
@@ -137,125 +54,116 @@ must try:
     uint >> uint
     int >> uint
 */
+template<unsigned Width>
 void test_pos_int_lb_rshift_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [a0, _] >> [b0, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [a0, _] >> [b0, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
     solver.add(a0 >= 0); // a is an integer
 
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     solver.add(b0 <= b1);
     // treat b like an integer
     solver.add(b1 >= 0);
-    solver.add(b1 < NBITS);
+    solver.add(b1 < Width);
 
     // interval.min = a_interval.min >> b_interval.max;
     z3::expr emin = int_shift_right(a0, b1);
     disallow_overflow(a0, b1, emin, /* aIsUint */false, solver);
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=false, .upper=zero, .lower=a0};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */false, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, Int(a0, std::nullopt), Int(b0, b1), Int(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_pos_uint_lb_rshift_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[a0, _] >> [b0, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[a0, _] >> [b0, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a0 = context.bv_const("a0", NBITS); // a is unsigned
+    z3::expr a0 = Int::Variable(context, "a0"); // a is unsigned
 
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
 
     // treat b like an integer
     solver.add(b0 <= b1);
     solver.add(b1 >= 0);
-    solver.add(b1 < NBITS);
+    solver.add(b1 < Width);
 
     // interval.min = a_interval.min >> b_interval.max;
     z3::expr emin = mixed_ui_shift_right(a0, b1);
     disallow_overflow(a0, b1, emin, /* aIsUint */true, solver);
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=true, .upper=zero, .lower=a0};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */true, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, UInt(a0, std::nullopt), Int(b0, b1), UInt(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_pos_uint_lb_rshift_uint() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[a0, _] >> u[b0, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[a0, _] >> u[b0, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a0 = context.bv_const("a0", NBITS); // a is unsigned
+    z3::expr a0 = Int::Variable(context, "a0"); // a is unsigned
 
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     // treat b as unsigned
     solver.add(z3::ule(b0, b1));
     solver.add(z3::uge(b1, 0));
-    solver.add(z3::ult(b1, NBITS));
+    solver.add(z3::ult(b1, Width));
 
     // interval.min = a_interval.min >> b_interval.max;
     z3::expr emin = uint_shift_right(a0, b1);
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=true, .upper=zero, .lower=a0};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=true, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */true, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, UInt(a0, std::nullopt), UInt(b0, b1), UInt(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_pos_int_lb_rshift_uint() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [a0, _] >> u[b0, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [a0, _] >> u[b0, b1] && b1 >= 0 && b1 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
     solver.add(a0 >= 0); // a is an integer
 
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     // treat b as unsigned
     solver.add(z3::ule(b0, b1));
     solver.add(z3::uge(b1, 0));
-    solver.add(z3::ult(b1, NBITS));
+    solver.add(z3::ult(b1, Width));
 
     // interval.min = a_interval.min >> b_interval.max;
     z3::expr emin = mixed_iu_shift_right(a0, b1);
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=false, .upper=zero, .lower=a0};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=true, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */false, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, Int(a0, std::nullopt), UInt(b0, b1), Int(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
 
@@ -270,35 +178,32 @@ can_prove(a_interval.min < 0) && b_max_ok_negative
 Note: a and b must be signed, only one case:
     int >> int
 */
+template<unsigned Width>
 void test_unk_int_lb_rshift_possibly_neg_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [a0, _] >> [b0, b1] && b1 < 0 && b1 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [a0, _] >> [b0, b1] && b1 < 0 && b1 > -t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
     // a is an integer
     solver.add(a0 < 0);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     solver.add(b0 <= b1);
     // treat b like an integer
     solver.add(b1 < 0);
-    solver.add(b1 > -NBITS);
+    solver.add(b1 > -(int)Width);
 
     // interval.min = a_interval.min << abs(b_interval.max);
     z3::expr emin = int_shift_right(a0, b1);
     disallow_overflow(a0, b1, emin, /* aIsUint */false, solver);
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=false, .upper=zero, .lower=a0};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */false, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, Int(a0, std::nullopt), Int(b0, b1), Int(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
 /*
@@ -316,23 +221,24 @@ must try:
     uint >> uint
     int >> uint
 */
+template<unsigned Width>
 void test_unk_int_lb_rshift_pos_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [a0, _] >> [b0, b1] && b1, b0 >= 0 && b0, b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [a0, _] >> [b0, b1] && b1, b0 >= 0 && b0, b1 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     // treat b as signed
     solver.add(b0 <= b1);
     solver.add(b1 >= 0);
-    solver.add(b1 <= NBITS);
+    solver.add(b1 <= Width);
     solver.add(b0 >= 0);
-    solver.add(b0 <= NBITS);
+    solver.add(b0 <= Width);
 
     // interval.min = min(a_interval.min >> b_interval.min,
     //                    a_interval.min >> b_interval.max);
@@ -340,32 +246,30 @@ void test_unk_int_lb_rshift_pos_int() {
     z3::expr temp_max = int_shift_right(a0, b1);
     z3::expr emin = ite(temp_min < temp_max, temp_min, temp_max); // min()
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=false, .upper=zero, .lower=a0};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */false, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, Int(a0, std::nullopt), Int(b0, b1), Int(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_unk_uint_lb_rshift_pos_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[a0, _] >> [b0, b1] && b1, b0 >= 0 && b0, b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[a0, _] >> [b0, b1] && b1, b0 >= 0 && b0, b1 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     // treat b as signed
     solver.add(b0 <= b1);
     solver.add(b1 >= 0);
-    solver.add(b1 <= NBITS);
+    solver.add(b1 <= Width);
     solver.add(b0 >= 0);
-    solver.add(b0 <= NBITS);
+    solver.add(b0 <= Width);
 
     // interval.min = min(a_interval.min >> b_interval.min,
     //                    a_interval.min >> b_interval.max);
@@ -373,32 +277,30 @@ void test_unk_uint_lb_rshift_pos_int() {
     z3::expr temp_max = mixed_ui_shift_right(a0, b1);
     z3::expr emin = ite(z3::ult(temp_min, temp_max), temp_min, temp_max); // min()
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=true, .upper=zero, .lower=a0};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */true, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, UInt(a0, std::nullopt), Int(b0, b1), UInt(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_unk_uint_lb_rshift_pos_uint() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[a0, _] >> u[b0, b1] && b1, b0 >= 0 && b0, b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[a0, _] >> u[b0, b1] && b1, b0 >= 0 && b0, b1 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     // treat b as unsigned
     solver.add(z3::ule(b0, b1));
     solver.add(z3::uge(b1, 0));
-    solver.add(z3::ult(b1, NBITS));
+    solver.add(z3::ult(b1, Width));
     solver.add(z3::uge(b0, 0));
-    solver.add(z3::ult(b0, NBITS));
+    solver.add(z3::ult(b0, Width));
 
     // interval.min = min(a_interval.min >> b_interval.min,
     //                    a_interval.min >> b_interval.max);
@@ -406,32 +308,30 @@ void test_unk_uint_lb_rshift_pos_uint() {
     z3::expr temp_max = uint_shift_right(a0, b1);
     z3::expr emin = ite(z3::ult(temp_min, temp_max), temp_min, temp_max); // min()
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=true, .upper=zero, .lower=a0};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=true, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */true, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, UInt(a0, std::nullopt), UInt(b0, b1), UInt(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_unk_int_lb_rshift_pos_uint() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [a0, _] >> u[b0, b1] && b1, b0 >= 0 && b0, b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [a0, _] >> u[b0, b1] && b1, b0 >= 0 && b0, b1 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     // treat b as unsigned
     solver.add(z3::ule(b0, b1));
     solver.add(z3::uge(b1, 0));
-    solver.add(z3::ult(b1, NBITS));
+    solver.add(z3::ult(b1, Width));
     solver.add(z3::uge(b0, 0));
-    solver.add(z3::ult(b0, NBITS));
+    solver.add(z3::ult(b0, Width));
 
     // interval.min = min(a_interval.min >> b_interval.min,
     //                    a_interval.min >> b_interval.max);
@@ -439,13 +339,9 @@ void test_unk_int_lb_rshift_pos_uint() {
     z3::expr temp_max = mixed_iu_shift_right(a0, b1);
     z3::expr emin = ite(temp_min < temp_max, temp_min, temp_max); // min()
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=false, .upper=zero, .lower=a0};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=true, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */false, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, Int(a0, std::nullopt), UInt(b0, b1), Int(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
 
@@ -465,23 +361,24 @@ Note: b must be signed, only two cases:
     uint >> int
 
 */
+template<unsigned Width>
 void test_unk_int_lb_rshift_neg_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [a0, _] >> [b0, b1] && b0, b1 < 0 && b0, b1 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [a0, _] >> [b0, b1] && b0, b1 < 0 && b0, b1 > -t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     solver.add(b0 <= b1);
     // b is signed
     solver.add(b0 < 0);
-    solver.add(b0 > -NBITS);
+    solver.add(b0 > -(int)Width);
     solver.add(b1 < 0);
-    solver.add(b1 > -NBITS);
+    solver.add(b1 > -(int)Width);
 
     /*
     interval.min = min(a_interval.min << abs(b_interval.min),
@@ -493,32 +390,30 @@ void test_unk_int_lb_rshift_neg_int() {
     disallow_overflow(a0, b0, temp_min, /* aIsUint */false, solver);
     disallow_overflow(a0, b1, temp_max, /* aIsUint */false, solver);
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=false, .upper=zero, .lower=a0};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */false, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, Int(a0, std::nullopt), Int(b0, b1), Int(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_unk_uint_lb_rshift_neg_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[a0, _] >> [b0, b1] && b0, b1 < 0 && b0, b1 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[a0, _] >> [b0, b1] && b0, b1 < 0 && b0, b1 > -t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a0 = context.bv_const("a0", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a0 = Int::Variable(context, "a0");
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     solver.add(b0 <= b1);
     // b is signed
     solver.add(b0 < 0);
-    solver.add(b0 > -NBITS);
+    solver.add(b0 > -(int)Width);
     solver.add(b1 < 0);
-    solver.add(b1 > -NBITS);
+    solver.add(b1 > -(int)Width);
 
     /*
     interval.min = min(a_interval.min << abs(b_interval.min),
@@ -529,13 +424,9 @@ void test_unk_uint_lb_rshift_neg_int() {
     z3::expr emin = ite(z3::ult(temp_min, temp_max), temp_min, temp_max); // min()
     // uints allowed to overflow
 
-    // a is uint, b is int
-    ShiftParams a_params = {.isUpperBounded=false, .isLowerBounded=true, .isUint=true, .upper=zero, .lower=a0};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */false, /* isUint */true, emin, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, UInt(a0, std::nullopt), Int(b0, b1), UInt(emin, std::nullopt)));
+    rule_output() << "-------------------" << std::endl;
 }
 
 
@@ -551,68 +442,64 @@ must try:
     int >> uint
     uint >> uint
 */
+template<unsigned Width>
 void test_possibly_pos_int_ub_rshift_uint() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [_, a1] >> u[b0, b1] && b0 >= 0 && b0 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [_, a1] >> u[b0, b1] && b0 >= 0 && b0 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
+    z3::expr a1 = Int::Variable(context, "a1");
     solver.add(a1 >= 0); // a is an integer
 
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     solver.add(z3::ule(b0, b1));
     // b is signed
     solver.add(z3::uge(b0, 0));
-    solver.add(z3::ult(b0, NBITS));
+    solver.add(z3::ult(b0, Width));
 
     // interval.max = a_interval.max >> b_interval.min;
     z3::expr emax = mixed_iu_shift_right(a1, b0);
     // the above can't overflow because b0 is strictly positive
     // disallow_overflow(a1, b0, emax, /* aIsUint */false, solver);
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=true, .isLowerBounded=false, .isUint=false, .upper=a1, .lower=zero};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=true, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */true, /* isUint */false, emax, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, Int(std::nullopt, a1), UInt(b0, b1), Int(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_possibly_pos_uint_ub_rshift_uint() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[_, a1] >> u[b0, b1] && b0 >= 0 && b0 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[_, a1] >> u[b0, b1] && b0 >= 0 && b0 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
+    z3::expr a1 = Int::Variable(context, "a1");
     solver.add(z3::uge(a1, 0)); // a is unsigned
 
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     solver.add(z3::ule(b0, b1));
     // b is signed
     solver.add(z3::uge(b0, 0));
-    solver.add(z3::ult(b0, NBITS));
+    solver.add(z3::ult(b0, Width));
 
     // interval.max = a_interval.max >> b_interval.min;
     z3::expr emax = uint_shift_right(a1, b0);
     // the above can't overflow because b0 is strictly positive
     // disallow_overflow(a1, b0, emax, /* aIsUint */false, solver);
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=true, .isLowerBounded=false, .isUint=true, .upper=a1, .lower=zero};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=true, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */true, /* isUint */true, emax, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, UInt(std::nullopt, a1), UInt(b0, b1), UInt(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
 
@@ -628,35 +515,32 @@ Note: a is neg, must be signed. b must also be signed
 must try:
     int >> int
 */
+template<unsigned Width>
 void test_neg_int_ub_rshift_possibly_neg_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [_, a1 (-)] >> [b0, b1] && b0 < 0 && b0 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [_, a1 (-)] >> [b0, b1] && b0 < 0 && b0 > -t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
+    z3::expr a1 = Int::Variable(context, "a1");
     solver.add(a1 < 0); // a is signed
 
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     // b is signed
     solver.add(b0 <= b1);
     solver.add(b0 < 0);
-    solver.add(b0 > -NBITS);
+    solver.add(b0 > -(int)Width);
 
     // interval.max = a_interval.max << abs(b_interval.min);
     z3::expr emax = int_shift_right(a1, b0);
     disallow_overflow(a1, b0, emax, /* aIsUint */false, solver);
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=true, .isLowerBounded=false, .isUint=false, .upper=a1, .lower=zero};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */true, /* isUint */false, emax, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, Int(std::nullopt, a1), Int(b0, b1), Int(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
 /*
@@ -673,24 +557,26 @@ must try:
     int >> uint
     uint >> uint
 */
+template<unsigned Width>
 void test_int_ub_rshift_pos_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [_, a1] >> u[b0, b1] && b0, b1 >= 0 && b0, b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [_, a1] >> u[b0, b1] && b0, b1 >= 0 && b0, b1 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
+    z3::expr a1 = Int::Variable(context, "a1");
 
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     // b is unsigned
     solver.add(z3::ule(b0, b1));
     solver.add(z3::uge(b1, 0));
-    solver.add(z3::ult(b1, NBITS));
+    solver.add(z3::ult(b1, Width));
     solver.add(z3::uge(b0, 0));
-    solver.add(z3::ult(b0, NBITS));
+    solver.add(z3::ult(b0, Width));
 
     /*
     interval.max = max(a_interval.max >> b_interval.max,
@@ -701,33 +587,31 @@ void test_int_ub_rshift_pos_int() {
     z3::expr emax = ite(temp_max > temp_min, temp_max, temp_min); // max()
     // the above can't overflow because b is strictly nonnegative
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=true, .isLowerBounded=false, .isUint=false, .upper=a1, .lower=zero};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=true, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */true, /* isUint */false, emax, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, Int(std::nullopt, a1), UInt(b0, b1), Int(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_uint_ub_rshift_pos_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[_, a1] >> u[b0, b1] && b0, b1 >= 0 && b0, b1 < t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[_, a1] >> u[b0, b1] && b0, b1 >= 0 && b0, b1 < t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
+    z3::expr a1 = Int::Variable(context, "a1");
 
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     // b is unsigned
     solver.add(z3::ule(b0, b1));
     solver.add(z3::uge(b1, 0));
-    solver.add(z3::ult(b1, NBITS));
+    solver.add(z3::ult(b1, Width));
     solver.add(z3::uge(b0, 0));
-    solver.add(z3::ult(b0, NBITS));
+    solver.add(z3::ult(b0, Width));
 
     /*
     interval.max = max(a_interval.max >> b_interval.max,
@@ -738,13 +622,9 @@ void test_uint_ub_rshift_pos_int() {
     z3::expr emax = ite(z3::ugt(temp_max, temp_min), temp_max, temp_min); // max()
     // the above can't overflow because b is strictly nonnegative
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=true, .isLowerBounded=false, .isUint=true, .upper=a1, .lower=zero};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=true, .upper=b1, .lower=b0};
-
     // output is lower bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */true, /* isUint */true, emax, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, UInt(std::nullopt, a1), UInt(b0, b1), UInt(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
 /*
@@ -763,23 +643,24 @@ must try:
     int >> int
     uint >> int
 */
+template<unsigned Width>
 void test_unk_int_ub_rshift_neg_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test [_, a1] >> [b0, b1] && b0, b1 < 0 && b0, b1 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test [_, a1] >> [b0, b1] && b0, b1 < 0 && b0, b1 > -t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a1 = Int::Variable(context, "a1");
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     // b is signed
     solver.add(b0 <= b1);
     solver.add(b0 < 0);
-    solver.add(b0 > -NBITS);
+    solver.add(b0 > -(int)Width);
     solver.add(b1 < 0);
-    solver.add(b1 > -NBITS);
+    solver.add(b1 > -(int)Width);
 
     /*
     interval.max = max(a_interval.max << abs(b_interval.max),
@@ -791,32 +672,30 @@ void test_unk_int_ub_rshift_neg_int() {
     disallow_overflow(a1, b0, temp_min, /* aIsUint */false, solver);
     disallow_overflow(a1, b1, temp_max, /* aIsUint */false, solver);
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=true, .isLowerBounded=false, .isUint=false, .upper=a1, .lower=zero};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
-
     // output is upper bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */true, /* isUint */false, emax, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, Int(std::nullopt, a1), Int(b0, b1), Int(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
+template<unsigned Width>
 void test_unk_uint_ub_rshift_neg_int() {
-    std::cout << "-------------------" << std::endl;
-    std::cout << "Test u[_, a1] >> [b0, b1] && b0, b1 < 0 && b0, b1 > -t.bits()" << std::endl;
+    rule_output() << "-------------------" << std::endl;
+    rule_output() << "Test u[_, a1] >> [b0, b1] && b0, b1 < 0 && b0, b1 > -t.bits()" << std::endl;
 
-    z3::context context;
+    z3::context &context = rule_context();
     z3::solver solver(context);
-    z3::expr zero = context.bv_val(0x0ull, NBITS);
+    typedef IntInterval<Width> Int;
+    typedef UIntInterval<Width> UInt;
 
-    z3::expr a1 = context.bv_const("a1", NBITS);
-    z3::expr b0 = context.bv_const("b0", NBITS);
-    z3::expr b1 = context.bv_const("b1", NBITS);
+    z3::expr a1 = Int::Variable(context, "a1");
+    z3::expr b0 = Int::Variable(context, "b0");
+    z3::expr b1 = Int::Variable(context, "b1");
     // b is signed
     solver.add(b0 <= b1);
     solver.add(b0 < 0);
-    solver.add(b0 > -NBITS);
+    solver.add(b0 > -(int)Width);
     solver.add(b1 < 0);
-    solver.add(b1 > -NBITS);
+    solver.add(b1 > -(int)Width);
 
     /*
     interval.max = max(a_interval.max << abs(b_interval.max),
@@ -828,32 +707,182 @@ void test_unk_uint_ub_rshift_neg_int() {
     // disallow_overflow(a1, b0, temp_min, /* aIsUint */false, solver);
     // disallow_overflow(a1, b1, temp_max, /* aIsUint */false, solver);
 
-    // both are integers for this test
-    ShiftParams a_params = {.isUpperBounded=true, .isLowerBounded=false, .isUint=true, .upper=a1, .lower=zero};
-    ShiftParams b_params = {.isUpperBounded=true, .isLowerBounded=true, .isUint=false, .upper=b1, .lower=b0};
-
     // output is upper bounded and integer
-    check_shift_right(a_params, b_params, /* isUpperBounded */true, /* isUint */true, emax, solver, context);
-    std::cout << "-------------------" << std::endl;
+    report(check_shift_right(solver, UInt(std::nullopt, a1), Int(b0, b1), UInt(std::nullopt, emax)));
+    rule_output() << "-------------------" << std::endl;
 }
 
-int main(int argc, char** argv) {
-    test_pos_int_lb_rshift_int(); // this one takes a very long time with NBITS=32
-    // test_pos_uint_lb_rshift_int(); // bug
-    test_pos_uint_lb_rshift_uint();
-    test_pos_int_lb_rshift_uint();
-    test_unk_int_lb_rshift_possibly_neg_int();
-    test_unk_int_lb_rshift_pos_int();
-    test_unk_uint_lb_rshift_pos_int();
-    test_unk_uint_lb_rshift_pos_uint();
-    test_unk_int_lb_rshift_pos_uint();
-    test_unk_int_lb_rshift_neg_int(); // this one takes a very long time with NBITS=32
-    // test_unk_uint_lb_rshift_neg_int(); // bug
-    test_possibly_pos_int_ub_rshift_uint();
-    test_possibly_pos_uint_ub_rshift_uint();
-    test_neg_int_ub_rshift_possibly_neg_int(); // this one takes a very long time with NBITS=32
-    test_int_ub_rshift_pos_int();
-    test_uint_ub_rshift_pos_int();
-    test_unk_int_ub_rshift_neg_int();
-    // test_unk_uint_ub_rshift_neg_int(); // bug
-}
\ No newline at end of file
+} // namespace
+
+static RuleGroup rules("shift_right", "shift_right", {"bv"}, {
+    BV_RULE(test_pos_int_lb_rshift_int, 8),
+    BV_RULE(test_pos_uint_lb_rshift_int, 8, "disabled"), // bug
+    BV_RULE(test_pos_uint_lb_rshift_uint, 8),
+    BV_RULE(test_pos_int_lb_rshift_uint, 8),
+    BV_RULE(test_unk_int_lb_rshift_possibly_neg_int, 8),
+    BV_RULE(test_unk_int_lb_rshift_pos_int, 8),
+    BV_RULE(test_unk_uint_lb_rshift_pos_int, 8),
+    BV_RULE(test_unk_uint_lb_rshift_pos_uint, 8),
+    BV_RULE(test_unk_int_lb_rshift_pos_uint, 8),
+    BV_RULE(test_unk_int_lb_rshift_neg_int, 8),
+    BV_RULE(test_unk_uint_lb_rshift_neg_int, 8, "disabled"), // bug
+    BV_RULE(test_possibly_pos_int_ub_rshift_uint, 8),
+    BV_RULE(test_possibly_pos_uint_ub_rshift_uint, 8),
+    BV_RULE(test_neg_int_ub_rshift_possibly_neg_int, 8),
+    BV_RULE(test_int_ub_rshift_pos_int, 8),
+    BV_RULE(test_uint_ub_rshift_pos_int, 8),
+    BV_RULE(test_unk_int_ub_rshift_neg_int, 8),
+    BV_RULE(test_unk_uint_ub_rshift_neg_int, 8, "disabled"), // bug
+});
+
+// the same rules at 8 bits, for --exhaustive
+static ExhaustiveGroup exhaustive("shift_right", {
+    {"pos_int_lb_rshift_int", {true, LowerEnd, true, BothEnds, shift_right8<true, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (a0 < 0 || b0 > b1 || b1 < 0 || b1 >= 8) {
+                return false;
+            }
+            lo = right_shift8(a0, b1, false, false);
+            return !right_shift_overflows8(a0, b1, lo, false);
+        }, LowerEnd, ">>"}},
+    {"pos_uint_lb_rshift_int", {false, LowerEnd, true, BothEnds, shift_right8<false, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b1 < 0 || b1 >= 8) {
+                return false;
+            }
+            lo = right_shift8(a0, b1, true, false);
+            return !right_shift_overflows8(a0, b1, lo, true);
+        }, LowerEnd, ">>"}},
+    {"pos_uint_lb_rshift_uint", {false, LowerEnd, false, BothEnds, shift_right8<false, false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b1 >= 8) {
+                return false;
+            }
+            lo = right_shift8(a0, b1, true, true);
+            return true;
+        }, LowerEnd, ">>"}},
+    {"pos_int_lb_rshift_uint", {true, LowerEnd, false, BothEnds, shift_right8<true, false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (a0 < 0 || b0 > b1 || b1 >= 8) {
+                return false;
+            }
+            lo = right_shift8(a0, b1, false, true);
+            return true;
+        }, LowerEnd, ">>"}},
+    {"unk_int_lb_rshift_possibly_neg_int", {true, LowerEnd, true, BothEnds, shift_right8<true, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (a0 >= 0 || b0 > b1 || b1 >= 0 || b1 <= -8) {
+                return false;
+            }
+            lo = right_shift8(a0, b1, false, false);
+            return !right_shift_overflows8(a0, b1, lo, false);
+        }, LowerEnd, ">>"}},
+    {"unk_int_lb_rshift_pos_int", {true, LowerEnd, true, BothEnds, shift_right8<true, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b1 < 0 || b1 > 8 || b0 < 0 || b0 > 8) {
+                return false;
+            }
+            lo = std::min(right_shift8(a0, b0, false, false), right_shift8(a0, b1, false, false));
+            return true;
+        }, LowerEnd, ">>"}},
+    {"unk_uint_lb_rshift_pos_int", {false, LowerEnd, true, BothEnds, shift_right8<false, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b1 < 0 || b1 > 8 || b0 < 0 || b0 > 8) {
+                return false;
+            }
+            lo = std::min(right_shift8(a0, b0, true, false), right_shift8(a0, b1, true, false));
+            return true;
+        }, LowerEnd, ">>"}},
+    {"unk_uint_lb_rshift_pos_uint", {false, LowerEnd, false, BothEnds, shift_right8<false, false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b1 >= 8 || b0 >= 8) {
+                return false;
+            }
+            lo = std::min(right_shift8(a0, b0, true, true), right_shift8(a0, b1, true, true));
+            return true;
+        }, LowerEnd, ">>"}},
+    {"unk_int_lb_rshift_pos_uint", {true, LowerEnd, false, BothEnds, shift_right8<true, false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b1 >= 8 || b0 >= 8) {
+                return false;
+            }
+            lo = std::min(right_shift8(a0, b0, false, true), right_shift8(a0, b1, false, true));
+            return true;
+        }, LowerEnd, ">>"}},
+    {"unk_int_lb_rshift_neg_int", {true, LowerEnd, true, BothEnds, shift_right8<true, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b0 >= 0 || b0 <= -8 || b1 >= 0 || b1 <= -8) {
+                return false;
+            }
+            int temp_min = right_shift8(a0, b0, false, false);
+            int temp_max = right_shift8(a0, b1, false, false);
+            lo = std::min(temp_min, temp_max);
+            return !right_shift_overflows8(a0, b0, temp_min, false) && !right_shift_overflows8(a0, b1, temp_max, false);
+        }, LowerEnd, ">>"}},
+    {"unk_uint_lb_rshift_neg_int", {false, LowerEnd, true, BothEnds, shift_right8<false, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b0 >= 0 || b0 <= -8 || b1 >= 0 || b1 <= -8) {
+                return false;
+            }
+            lo = std::min(right_shift8(a0, b0, true, false), right_shift8(a0, b1, true, false));
+            return true;
+        }, LowerEnd, ">>"}},
+    {"possibly_pos_int_ub_rshift_uint", {true, UpperEnd, false, BothEnds, shift_right8<true, false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (a1 < 0 || b0 > b1 || b0 >= 8) {
+                return false;
+            }
+            hi = right_shift8(a1, b0, false, true);
+            return true;
+        }, UpperEnd, ">>"}},
+    {"possibly_pos_uint_ub_rshift_uint", {false, UpperEnd, false, BothEnds, shift_right8<false, false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b0 >= 8) {
+                return false;
+            }
+            hi = right_shift8(a1, b0, true, true);
+            return true;
+        }, UpperEnd, ">>"}},
+    {"neg_int_ub_rshift_possibly_neg_int", {true, UpperEnd, true, BothEnds, shift_right8<true, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (a1 >= 0 || b0 > b1 || b0 >= 0 || b0 <= -8) {
+                return false;
+            }
+            hi = right_shift8(a1, b0, false, false);
+            return !right_shift_overflows8(a1, b0, hi, false);
+        }, UpperEnd, ">>"}},
+    {"int_ub_rshift_pos_int", {true, UpperEnd, false, BothEnds, shift_right8<true, false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b1 >= 8 || b0 >= 8) {
+                return false;
+            }
+            hi = std::max(right_shift8(a1, b1, false, true), right_shift8(a1, b0, false, true));
+            return true;
+        }, UpperEnd, ">>"}},
+    {"uint_ub_rshift_pos_int", {false, UpperEnd, false, BothEnds, shift_right8<false, false>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b1 >= 8 || b0 >= 8) {
+                return false;
+            }
+            hi = std::max(right_shift8(a1, b1, true, true), right_shift8(a1, b0, true, true));
+            return true;
+        }, UpperEnd, ">>"}},
+    {"unk_int_ub_rshift_neg_int", {true, UpperEnd, true, BothEnds, shift_right8<true, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b0 >= 0 || b0 <= -8 || b1 >= 0 || b1 <= -8) {
+                return false;
+            }
+            int temp_min = right_shift8(a1, b0, false, false);
+            int temp_max = right_shift8(a1, b1, false, false);
+            hi = std::max(temp_min, temp_max);
+            return !right_shift_overflows8(a1, b0, temp_min, false) && !right_shift_overflows8(a1, b1, temp_max, false);
+        }, UpperEnd, ">>"}},
+    {"unk_uint_ub_rshift_neg_int", {false, UpperEnd, true, BothEnds, shift_right8<false, true>,
+        [](int a0, int a1, int b0, int b1, int &lo, int &hi) {
+            if (b0 > b1 || b0 >= 0 || b0 <= -8 || b1 >= 0 || b1 <= -8) {
+                return false;
+            }
+            hi = std::max(right_shift8(a1, b0, true, false), right_shift8(a1, b1, true, false));
+            return true;
+        }, UpperEnd, ">>"}},
+});
@@ -0,0 +1,347 @@
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Check.h"
+#include "Dedup.h"
+#include "Dual.h"
+#include "Exhaustive.h"
+#include "HalideType.h"
+#include "Overflow.h"
+#include "Registry.h"
+#include "Report.h"
+#include "Runner.h"
+#include "ShiftEncoding.h"
+#include "ShiftMatrix.h"
+#include "Sweep.h"
+
+// false unless text is a whole number that fits in an unsigned
+static bool parse_unsigned(const char *text, unsigned &value) {
+    char *end = nullptr;
+    errno = 0;
+    unsigned long parsed = std::strtoul(text, &end, 10);
+    if (!isdigit(text[0]) || *end != '\0' || errno == ERANGE || parsed > UINT_MAX) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+// false unless text is a positive number
+static bool parse_positive(const char *text, double &value) {
+    char *end = nullptr;
+    double parsed = std::strtod(text, &end);
+    if (end == text || *end != '\0' || !(parsed > 0) || !std::isfinite(parsed)) {
+        return false;
+    }
+    value = parsed;
+    return true;
+}
+
+// "8,16,32" -> {8, 16, 32}, false unless every item is a width of 1 to 64 bits
+static bool parse_widths(const char *list, std::vector<unsigned> &widths) {
+    widths.clear();
+    std::stringstream items(list);
+    std::string width;
+    while (std::getline(items, width, ',')) {
+        unsigned bits;
+        if (!parse_unsigned(width.c_str(), bits) || bits < 1 || bits > 64) {
+            return false;
+        }
+        widths.push_back(bits);
+    }
+    return !widths.empty();
+}
+
+void usage(const char *argv0) {
+    std::cerr << "Usage: " << argv0 << " [options] [glob...]" << std::endl;
+    std::cerr << "Runs every registered rule whose name matches one of the globs." << std::endl;
+    std::cerr << std::endl;
+    std::cerr << "  --list               print the selected rules instead of running them" << std::endl;
+    std::cerr << "  --op <op>            only select rules for operator <op> (repeatable)" << std::endl;
+    std::cerr << "  --tag <tag>          only select rules with tag <tag> (repeatable)" << std::endl;
+    std::cerr << "  -j, --jobs <n>       run <n> rules at a time (default: one per core)" << std::endl;
+    std::cerr << "  --timeout <ms>       give up on any single query after <ms> milliseconds" << std::endl;
+    std::cerr << "  --isolate            run every rule in its own worker process" << std::endl;
+    std::cerr << "  --rule-timeout <s>   kill a worker after <s> seconds (implies --isolate)" << std::endl;
+    std::cerr << "  --memory <MB>        cap each worker at <MB> megabytes (implies --isolate)" << std::endl;
+    std::cerr << "  --portfolio          race several solver configurations on every query" << std::endl;
+    std::cerr << "  --cache-dir <dir>    remember verdicts in <dir> (default: .verify-bounds-cache)" << std::endl;
+    std::cerr << "  --no-cache           neither read nor write the proof cache" << std::endl;
+    std::cerr << "  --recheck            solve every query anyway and correct the cache" << std::endl;
+    std::cerr << "  --changed            only run rules whose sources changed since their last run" << std::endl;
+    std::cerr << "  --no-dedup           solve every query, even one identical to a query already" << std::endl;
+    std::cerr << "                       solved in this run" << std::endl;
+    std::cerr << "  --classify           solve every query with the tactic tuned for its logic" << std::endl;
+    std::cerr << "  --dual               try every bit-vector query over the integers first" << std::endl;
+    std::cerr << "  --dual-budget <ms>   how long the integers get before bit-vectors take over" << std::endl;
+    std::cerr << "                       (default: 250, implies --dual)" << std::endl;
+    std::cerr << "  --dual-savings       also time the bit-vector query of every integer proof" << std::endl;
+    std::cerr << "                       (implies --dual)" << std::endl;
+    std::cerr << "  --family             check the rules of a family (mul, div) in one solver" << std::endl;
+    std::cerr << "  --sweep              run the bit-vector rules at 8, 16, 32 and 64 bits and" << std::endl;
+    std::cerr << "                       tabulate verdict and solver time per width" << std::endl;
+    std::cerr << "  --widths <w,w,...>   the widths to sweep (implies --sweep)" << std::endl;
+    std::cerr << "  --growth <factor>    flag rules slowing down more than <factor> per doubled" << std::endl;
+    std::cerr << "                       width in a sweep (default: 4)" << std::endl;
+    std::cerr << "  --staged             check the bit-vector rules at 4 and 8 bits first and only" << std::endl;
+    std::cerr << "                       prove the survivors at 32 and 64 bits" << std::endl;
+    std::cerr << "  --screen <w,w,...>   the widths to screen at (implies --staged)" << std::endl;
+    std::cerr << "  --prove <w,w,...>    the widths to prove at (implies --staged)" << std::endl;
+    std::cerr << "  --exhaustive         decide the bit-vector rules that have an exhaustive twin" << std::endl;
+    std::cerr << "                       at 8 bits by trying every operand interval, without z3" << std::endl;
+    std::cerr << "  --shift-matrix       generate every signedness and bounds combination of the" << std::endl;
+    std::cerr << "                       shift rules and check it at each --widths (default 8-64)" << std::endl;
+    std::cerr << "  --symbolic           first try each --shift-matrix case at every width at once" << std::endl;
+    std::cerr << "                       (implies --shift-matrix)" << std::endl;
+    std::cerr << "  --symbolic-budget <ms> how long that may take (default: 20000, implies --symbolic)" << std::endl;
+    std::cerr << "  --shift-bench        check the --shift-matrix cases at each --widths in every" << std::endl;
+    std::cerr << "                       shift encoding and pick the fastest for each type" << std::endl;
+    std::cerr << "  --overflow <encoding> how shift rules detect lost bits: shift (default), mul, or" << std::endl;
+    std::cerr << "                       count, the popcount encoding the rules started with" << std::endl;
+    std::cerr << "  --halide-types       give each width its own Halide type's overflow semantics," << std::endl;
+    std::cerr << "                       so Int(8) and Int(16) wrap, and sweep the widths of" << std::endl;
+    std::cerr << "                       the production types (implies --sweep)" << std::endl;
+    std::cerr << "  --shift-encoding <e> how shifts are built: barrel (default), chain, mul or split," << std::endl;
+    std::cerr << "                       for every type or per type, e.g. 'Int(8)=chain,UInt(8)=mul'" << std::endl;
+    std::cerr << "  --timing             print the solver time after every verdict" << std::endl;
+    std::cerr << "  --include-disabled   also select rules tagged \"disabled\"" << std::endl;
+    std::cerr << "  --help               print this message" << std::endl;
+}
+
+int main(int argc, char** argv) {
+    RuleFilter filter;
+    bool list = false;
+    unsigned jobs = std::thread::hardware_concurrency();
+    RunOptions options;
+    bool sweep = false;
+    SweepOptions sweep_options;
+    bool staged = false;
+    StagedOptions staged_options;
+    bool exhaustive = false;
+    bool shift_matrix = false;
+    bool shift_bench = false;
+    unsigned symbolic_budget_ms = 0;
+    bool no_cache = false;
+    solve_options().cache_dir = ".verify-bounds-cache";
+
+    for (int arg = 1; arg < argc; arg++) {
+        if (!strcmp(argv[arg], "--list")) {
+            list = true;
+        } else if (!strcmp(argv[arg], "--op") && arg + 1 < argc) {
+            filter.ops.push_back(argv[++arg]);
+        } else if (!strcmp(argv[arg], "--tag") && arg + 1 < argc) {
+            filter.tags.push_back(argv[++arg]);
+        } else if ((!strcmp(argv[arg], "--jobs") || !strcmp(argv[arg], "-j")) && arg + 1 < argc) {
+            if (!parse_unsigned(argv[++arg], jobs)) {
+                std::cerr << "Bad number for " << argv[arg - 1] << ": " << argv[arg] << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[arg], "--timeout") && arg + 1 < argc) {
+            if (!parse_unsigned(argv[++arg], options.query_timeout_ms)) {
+                std::cerr << "Bad number for " << argv[arg - 1] << ": " << argv[arg] << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[arg], "--isolate")) {
+            options.isolate = true;
+        } else if (!strcmp(argv[arg], "--rule-timeout") && arg + 1 < argc) {
+            if (!parse_unsigned(argv[++arg], options.rule_timeout_s)) {
+                std::cerr << "Bad number for " << argv[arg - 1] << ": " << argv[arg] << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+            options.isolate = true;
+        } else if (!strcmp(argv[arg], "--memory") && arg + 1 < argc) {
+            if (!parse_unsigned(argv[++arg], options.memory_mb)) {
+                std::cerr << "Bad number for " << argv[arg - 1] << ": " << argv[arg] << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+            options.isolate = true;
+        } else if (!strcmp(argv[arg], "--portfolio")) {
+            solve_options().portfolio = true;
+        } else if (!strcmp(argv[arg], "--cache-dir") && arg + 1 < argc) {
+            solve_options().cache_dir = argv[++arg];
+        } else if (!strcmp(argv[arg], "--no-cache")) {
+            no_cache = true;
+        } else if (!strcmp(argv[arg], "--recheck")) {
+            solve_options().recheck = true;
+        } else if (!strcmp(argv[arg], "--changed")) {
+            options.only_changed = true;
+        } else if (!strcmp(argv[arg], "--dual")) {
+            solve_options().dual = true;
+        } else if (!strcmp(argv[arg], "--dual-budget") && arg + 1 < argc) {
+            solve_options().dual = true;
+            if (!parse_unsigned(argv[++arg], solve_options().dual_budget_ms)) {
+                std::cerr << "Bad number for " << argv[arg - 1] << ": " << argv[arg] << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[arg], "--dual-savings")) {
+            solve_options().dual = true;
+            solve_options().dual_savings = true;
+        } else if (!strcmp(argv[arg], "--no-dedup")) {
+            solve_options().dedup = false;
+        } else if (!strcmp(argv[arg], "--classify")) {
+            solve_options().classify = true;
+        } else if (!strcmp(argv[arg], "--family")) {
+            options.families = true;
+        } else if (!strcmp(argv[arg], "--sweep")) {
+            sweep = true;
+        } else if (!strcmp(argv[arg], "--widths") && arg + 1 < argc) {
+            sweep = true;
+            if (!parse_widths(argv[++arg], sweep_options.widths)) {
+                std::cerr << "Bad width list for --widths: " << argv[arg] << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[arg], "--staged")) {
+            staged = true;
+        } else if (!strcmp(argv[arg], "--screen") && arg + 1 < argc) {
+            staged = true;
+            if (!parse_widths(argv[++arg], staged_options.screen)) {
+                std::cerr << "Bad width list for --screen: " << argv[arg] << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[arg], "--prove") && arg + 1 < argc) {
+            staged = true;
+            if (!parse_widths(argv[++arg], staged_options.prove)) {
+                std::cerr << "Bad width list for --prove: " << argv[arg] << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[arg], "--growth") && arg + 1 < argc) {
+            if (!parse_positive(argv[++arg], sweep_options.growth)) {
+                std::cerr << "Bad number for " << argv[arg - 1] << ": " << argv[arg] << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[arg], "--exhaustive")) {
+            exhaustive = true;
+        } else if (!strcmp(argv[arg], "--shift-matrix")) {
+            shift_matrix = true;
+        } else if (!strcmp(argv[arg], "--symbolic")) {
+            shift_matrix = true;
+            symbolic_budget_ms = 20000;
+        } else if (!strcmp(argv[arg], "--symbolic-budget") && arg + 1 < argc) {
+            shift_matrix = true;
+            if (!parse_unsigned(argv[++arg], symbolic_budget_ms)) {
+                std::cerr << "Bad number for " << argv[arg - 1] << ": " << argv[arg] << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[arg], "--shift-bench")) {
+            shift_bench = true;
+        } else if (!strcmp(argv[arg], "--shift-encoding") && arg + 1 < argc) {
+            if (!ParseShiftEncodings(argv[++arg])) {
+                std::cerr << "Unknown shift encoding: " << argv[arg] << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (!strcmp(argv[arg], "--overflow") && arg + 1 < argc) {
+            OverflowEncoding encoding;
+            if (!ParseOverflowEncoding(argv[++arg], encoding)) {
+                std::cerr << "Unknown overflow encoding: " << argv[arg] << std::endl;
+                usage(argv[0]);
+                return 1;
+            }
+            set_overflow_encoding(encoding);
+        } else if (!strcmp(argv[arg], "--halide-types")) {
+            set_type_semantics(ExactTypes);
+            sweep = true;
+        } else if (!strcmp(argv[arg], "--timing")) {
+            set_report_timing(true);
+        } else if (!strcmp(argv[arg], "--include-disabled")) {
+            filter.include_disabled = true;
+        } else if (!strcmp(argv[arg], "--help")) {
+            usage(argv[0]);
+            return 0;
+        } else if (argv[arg][0] == '-') {
+            std::cerr << "Unknown option: " << argv[arg] << std::endl;
+            usage(argv[0]);
+            return 1;
+        } else {
+            filter.globs.push_back(argv[arg]);
+        }
+    }
+
+    if (no_cache) {
+        solve_options().cache_dir.clear();
+    } else {
+        // reports live next to the verdicts they were built from
+        options.results_dir = solve_options().cache_dir + "/rules";
+    }
+    if (options.only_changed && (options.results_dir.empty() || solve_options().recheck)) {
+        std::cerr << "--changed needs the cache and cannot be combined with --recheck" << std::endl;
+        return 1;
+    }
+
+    if (shift_matrix || shift_bench) {
+        // globs pick cases rather than rules, and --widths means the matrix's widths
+        solve_options().cache_dir.clear();
+        solve_options().dedup = false;
+        if (options.query_timeout_ms == 0) {
+            options.query_timeout_ms = 60000;
+        }
+        if (shift_bench) {
+            run_shift_benchmark(filter.globs, sweep_options.widths, jobs, options);
+        } else {
+            run_shift_matrix(filter.globs, sweep_options.widths, jobs, options, symbolic_budget_ms);
+        }
+        return 0;
+    }
+
+    std::vector<const Rule *> rules = select_rules(filter);
+
+    if (list) {
+        for (const Rule *rule : rules) {
+            std::cout << rule->name << " [" << rule->op << "]";
+            for (const std::string &tag : rule->tags) {
+                std::cout << " " << tag;
+            }
+            std::cout << std::endl;
+        }
+        return 0;
+    }
+
+    if (exhaustive) {
+        run_exhaustive(rules, jobs);
+        return 0;
+    }
+
+    if (staged) {
+        run_staged(rules, jobs, options, staged_options);
+    } else if (sweep) {
+        // the sweep is about solver time, cached or shared verdicts would hide it
+        solve_options().cache_dir.clear();
+        solve_options().dedup = false;
+        if (options.query_timeout_ms == 0) {
+            options.query_timeout_ms = 60000;
+        }
+        run_sweep(rules, jobs, options, sweep_options);
+    } else {
+        run_rules(rules, jobs, options);
+    }
+
+    if (solve_options().dedup && !options.isolate && dedup_tally().shared > 0) {
+        std::cout << std::endl;
+        print_dedup_summary(std::cout);
+    }
+    if (solve_options().dual) {
+        // isolated workers keep their own counts, only this process's are known
+        std::cout << std::endl;
+        print_dual_summary(std::cout);
+    }
+    return 0;
+}
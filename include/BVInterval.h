@@ -0,0 +1,163 @@
+#pragma once
+
+#include "z3++.h"
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <string>
+
+#include "Check.h"
+#include "HalideType.h"
+
+// The bit-vector counterpart of Interval: [lower, upper] over Width-bit
+// values compared as Halide's Int (Signed) or UInt, either end possibly
+// unbounded. Bit-vector rules are templates over Width, so the same rule
+// can be checked at any width.
+template<unsigned Width, bool Signed>
+struct BVInterval {
+    static constexpr unsigned width = Width;
+    static constexpr bool is_signed = Signed;
+
+    BVInterval(std::optional<z3::expr> lower, std::optional<z3::expr> upper)
+        : lower(std::move(lower)), upper(std::move(upper)) {}
+
+    // the Halide type the interval's values have
+    static HalideType Type() {
+        return {Signed, Width};
+    }
+
+    static z3::expr Variable(z3::context &context, const std::string &name) {
+        return Type().Variable(context, name);
+    }
+
+    static z3::expr Value(z3::context &context, int64_t value) {
+        return Type().Value(context, value);
+    }
+
+    // comparisons, min and max in this interval's signedness
+    static z3::expr LessEqual(const z3::expr &a, const z3::expr &b) {
+        return Type().LessEqual(a, b);
+    }
+
+    static z3::expr Less(const z3::expr &a, const z3::expr &b) {
+        return Type().Less(a, b);
+    }
+
+    static z3::expr Min(const z3::expr &a, const z3::expr &b) {
+        return Type().Min(a, b);
+    }
+
+    static z3::expr Max(const z3::expr &a, const z3::expr &b) {
+        return Type().Max(a, b);
+    }
+
+    // lower <= value <= upper, for the ends that are bounded
+    z3::expr Contains(const z3::expr &value) const {
+        z3::expr_vector inside(value.ctx());
+        if (lower) {
+            inside.push_back(LessEqual(*lower, value));
+        }
+        if (upper) {
+            inside.push_back(LessEqual(value, *upper));
+        }
+        if (inside.empty()) {
+            return value.ctx().bool_val(true);
+        }
+        return (inside.size() == 1) ? inside[0] : z3::mk_and(inside);
+    }
+
+    // e.g. "u[#x03, _]"
+    std::string ToString(z3::model &model) const {
+        std::ostringstream out;
+        out << (Signed ? "" : "u") << "[";
+        out << (lower ? model.eval(*lower).to_string() : "_") << ", ";
+        out << (upper ? model.eval(*upper).to_string() : "_") << "]";
+        return out.str();
+    }
+
+    std::optional<z3::expr> lower, upper;
+};
+
+template<unsigned Width>
+using IntInterval = BVInterval<Width, true>;
+
+template<unsigned Width>
+using UIntInterval = BVInterval<Width, false>;
+
+template<unsigned Width, bool Signed>
+void apply_bv_interval(z3::solver &solver, const BVInterval<Width, Signed> &interval, const z3::expr &variable) {
+    if (interval.lower || interval.upper) {
+        solver.add(interval.Contains(variable));
+    }
+}
+
+// A fresh solver holding the assertions of solver. Every check gets its own,
+// since z3 only bit-blasts a solver that was never pushed, and that is by far
+// the fastest way to decide these queries.
+inline z3::solver bv_query(z3::solver &solver) {
+    z3::solver query(solver.ctx());
+    z3::expr_vector assertions = solver.assertions();
+    for (unsigned a = 0; a < assertions.size(); a++) {
+        query.add(assertions[a]);
+    }
+    return query;
+}
+
+// Can i op j, with i in a and j in b, fall outside result? Anything else
+// the rule needs (restrictions on the bounds, shift amounts in range, no
+// overflow) must already be asserted on solver, which is left untouched.
+template<unsigned Width, bool ASigned, bool BSigned, bool RSigned>
+CheckResult check_bv(z3::solver &solver, const std::string &op,
+                        const BVInterval<Width, ASigned> &a, const z3::expr &i,
+                        const BVInterval<Width, BSigned> &b, const z3::expr &j,
+                        const z3::expr &res, const BVInterval<Width, RSigned> &result) {
+    z3::solver query = bv_query(solver);
+    apply_bv_interval(query, a, i);
+    apply_bv_interval(query, b, j);
+    query.add(!result.Contains(res));
+
+    return solve(query, [=](std::ostream &out, z3::model &model) {
+        out << a.ToString(model) << " " << op << " " << b.ToString(model) << std::endl;
+        out << "Resultant bounds: " << result.ToString(model) << std::endl;
+        out << "Contradiction: ";
+        out << model.eval(i) << " " << op << " " << model.eval(j);
+        out << " = " << model.eval(res) << std::endl;
+    });
+}
+
+// the same for a unary operator, op i with i in a
+template<unsigned Width, bool ASigned, bool RSigned>
+CheckResult check_bv(z3::solver &solver, const std::string &op,
+                        const BVInterval<Width, ASigned> &a, const z3::expr &i,
+                        const z3::expr &res, const BVInterval<Width, RSigned> &result) {
+    z3::solver query = bv_query(solver);
+    apply_bv_interval(query, a, i);
+    query.add(!result.Contains(res));
+
+    return solve(query, [=](std::ostream &out, z3::model &model) {
+        out << op << " " << a.ToString(model) << std::endl;
+        out << "Resultant bounds: " << result.ToString(model) << std::endl;
+        out << "Contradiction: " << op << model.eval(i) << " = " << model.eval(res) << std::endl;
+    });
+}
+
+// Is each bounded end of result attained by some i op j, with i in a and j
+// in b? Same requirements on solver as check_bv.
+template<unsigned Width, bool ASigned, bool BSigned, bool RSigned>
+TightnessResult check_bv_tightness(z3::solver &solver,
+                                    const BVInterval<Width, ASigned> &a, const z3::expr &i,
+                                    const BVInterval<Width, BSigned> &b, const z3::expr &j,
+                                    const z3::expr &res, const BVInterval<Width, RSigned> &result) {
+    TightnessResult tightness;
+    for (const std::optional<z3::expr> *end : {&result.lower, &result.upper}) {
+        if (!*end) {
+            continue;
+        }
+        z3::solver query = bv_query(solver);
+        apply_bv_interval(query, a, i);
+        apply_bv_interval(query, b, j);
+        query.add(res == **end);
+        (end == &result.lower ? tightness.lower : tightness.upper) = solve(query);
+    }
+    return tightness;
+}
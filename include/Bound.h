@@ -22,13 +22,13 @@ struct Bound {
     Restriction restriction;
     BoundType type;
     z3::expr expr;
-    Bound(Restriction _restriction, BoundType _type, z3::expr &_expr)
+    Bound(Restriction _restriction, BoundType _type, const z3::expr &_expr)
         : restriction(_restriction), type(_type), expr(_expr) {}
-    std::string ToString(z3::model &m);
-    std::string ToStringSymbolic(bool print=false);
+    std::string ToString(z3::model &m) const;
+    std::string ToStringSymbolic(bool print=false) const;
 };
 
 
-void apply_bound(z3::solver &solver, z3::expr &variable, Bound *bound);
+void apply_bound(z3::solver &solver, const z3::expr &variable, const Bound &bound);
 
-void apply_restriction(z3::solver &solver, Bound *bound);
\ No newline at end of file
+void apply_restriction(z3::solver &solver, const Bound &bound);
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "z3++.h"
+#include <string>
+#include <vector>
+
+#include "Check.h"
+
+// A query in canonical form: every comparison turned to < or <=, the
+// assertions (and assumptions) sorted by their shape, and every constant
+// renamed v0, v1, ... in order of first use, so queries that only differ
+// in names, order or the direction of comparisons share a cache entry.
+// The text declares the sort of every vN, so widths never share one.
+struct CanonicalQuery {
+    std::string text;
+    std::string key;                // hash of text and parameters, in hex
+    std::vector<z3::expr> constants; // the original constant for each vN
+};
+
+// a stable hash of data, as 16 hex digits
+std::string hash_hex(const std::string &data);
+
+// parameters should name everything besides the formula that can change
+// the answer, the z3 version is added here
+CanonicalQuery canonicalize(const z3::expr_vector &assertions, const z3::expr_vector &assumptions,
+                            const std::string &parameters);
+
+// the value a model gives the constant vN of a canonical query
+struct ConstantValue {
+    size_t constant;
+    std::string value;
+};
+
+// The values model gives the query's constants, false if it cannot be
+// written down this way, i.e. assigns anything but numerals or booleans.
+bool model_values(const CanonicalQuery &query, const z3::model &model, std::vector<ConstantValue> &values);
+// the model for another query with the same canonical form, in its context
+z3::model model_from_values(const CanonicalQuery &query, z3::context &context,
+                            const std::vector<ConstantValue> &values);
+
+// Fills in status and model from the entry in dir, if there is one for
+// exactly this query. Only sat and unsat are ever stored.
+bool cache_load(const std::string &dir, const CanonicalQuery &query, z3::context &context,
+                CheckResult &result);
+
+// Stores a sat or unsat result. A sat is only stored if its model can be
+// written down, i.e. assigns numerals or booleans to constants.
+void cache_store(const std::string &dir, const CanonicalQuery &query, const CheckResult &result);
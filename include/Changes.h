@@ -0,0 +1,20 @@
+#pragma once
+
+#include <string>
+
+#include "Registry.h"
+
+// Everything a rule's report depends on, hashed: its own test function, the
+// rest of its source file without the other rules' bodies, every local
+// header it includes (transitively) along with the src/ file implementing
+// it, the z3 version and the given options. Empty if the rule's source
+// cannot be read, such a rule is always run.
+std::string rule_fingerprint(const Rule &rule, const std::string &options);
+
+// the report recorded for the rule in dir, if it was recorded under the
+// same fingerprint
+bool load_rule_report(const std::string &dir, const Rule &rule, const std::string &fingerprint,
+                        std::string &report);
+
+void store_rule_report(const std::string &dir, const Rule &rule, const std::string &fingerprint,
+                        const std::string &report);
@@ -1,19 +1,132 @@
 #pragma once
 
 #include "z3++.h"
-#include <string>
+#include <functional>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <utility>
 #include "Bound.h"
 #include "Interval.h"
 #include "Operations.h"
+#include "Registry.h"
+
+// renders a counterexample from a sat model
+typedef std::function<void(std::ostream &out, z3::model &model)> Describe;
+
+// A sat model and how the checker describes it. Nothing is evaluated until
+// a reporter asks for the text, and then only once, so runs that only
+// count verdicts pay nothing for their counterexamples. Describe functions
+// are kept until then, so they capture the terms they print by value.
+class Counterexample {
+public:
+    Counterexample() = default;
+    Counterexample(const z3::model &model, Describe describe)
+        : model(model), describe(std::move(describe)) {}
+
+    // the description, empty if the checker gave none
+    const std::string &Text() const;
+    // renders now and lets go of the model, which must not outlive its context
+    void Freeze() { Text(); }
+    void Clear();
+
+private:
+    mutable std::optional<z3::model> model;
+    mutable Describe describe;
+    mutable std::string text;
+};
+
+inline std::ostream &operator<<(std::ostream &out, const Counterexample &counterexample) {
+    return out << counterexample.Text();
+}
+
+// the outcome of one solver call
+struct CheckResult {
+    z3::check_result status = z3::unknown;
+    std::string reason_unknown;         // when unknown
+    std::optional<z3::model> model;     // when sat
+    Counterexample counterexample;      // the model as the checker describes it, when sat
+    std::string statement;              // what was checked, reported with proved/unknown
+    double seconds = 0;                 // time spent in the solver
+    std::string logic;                  // the classification, when classifying
+    std::string solved_by;              // the strategy that answered, if not the plain solver
+    bool cached = false;                // taken from the proof cache
+    bool shared = false;                // taken from an identical query of this run
+    bool stale_cache = false;           // rechecked, and the cache said otherwise
+};
+
+// how solve() goes about a query, set up before any rule runs
+struct SolveOptions {
+    // race several solver configurations on every query (see Portfolio.h)
+    bool portfolio = false;
+    // solve every query with the tactic tuned for its logic (see Logic.h)
+    bool classify = false;
+    // where proved and refuted queries are remembered, empty for no cache
+    // (see Cache.h)
+    std::string cache_dir;
+    // solve anyway and correct the cache where it disagrees
+    bool recheck = false;
+    // try bit-vector queries over the integers first, for at most
+    // dual_budget_ms (see Dual.h)
+    bool dual = false;
+    unsigned dual_budget_ms = 250;
+    // also solve what the integers proved as bit-vectors, to time the saving
+    bool dual_savings = false;
+    // solve each distinct query once per run (see Dedup.h)
+    bool dedup = true;
+};
+
+SolveOptions &solve_options();
+
+// Checks the solver exactly once. Every query goes through here.
+CheckResult solve(z3::solver &solver, const Describe &describe = nullptr);
+CheckResult solve(z3::solver &solver, const z3::expr_vector &assumptions,
+                    const Describe &describe = nullptr);
+
+// one result per bounded end of the interval
+struct TightnessResult {
+    std::optional<CheckResult> lower;
+    std::optional<CheckResult> upper;
+};
+
+// Lets the rules of one group share a single solver. While a Family is
+// alive, every Session created in its context asserts its intervals under
+// a fresh case literal and checks with that literal as an assumption, so
+// z3 sets up the theory for the operator once for the whole group.
+struct Family {
+    explicit Family(z3::context &context);
+    ~Family();
+    Family(const Family &) = delete;
+    Family &operator=(const Family &) = delete;
+
+    z3::expr NewCase();
+
+    // the family on this thread, nullptr if none
+    static Family *Current();
 
+    z3::context &context;
+    z3::solver solver;
+    unsigned cases = 0;
+    Family *previous;
+};
 
-void check(z3::context &context, Operation op, Interval *a, 
-            Interval *b, Bound &e0, Bound &e1);
+// One incremental solver per rule. The intervals are asserted once and
+// every query only adds its own goal inside a push/pop scope, so z3 keeps
+// what it learned about the intervals from one query to the next.
+// Borrows a and b, which have to outlive it.
+struct Session {
+    Session(z3::context &context, Operation op, const Interval &a, const Interval &b);
+    Session(const Session &) = delete;
+    Session &operator=(const Session &) = delete;
 
-// will deallocate a and b
-void check_tightness(z3::context &context, Operation op, Interval *a, 
-            Interval *b, Bound &e0, Bound &e1);
+    // can op(a, b) fall outside [e0, e1]?
+    CheckResult Check(Bound &e0, Bound &e1);
+    // is each bounded end of [e0, e1] attained by some op(a, b)?
+    TightnessResult CheckTightness(Bound &e0, Bound &e1);
 
-// void check(z3::context &context, Operation op, Interval *a, 
-//             Interval *b, z3::expr &e0, z3::expr &e1);
\ No newline at end of file
+    Operation op;
+    const Interval &a, &b;
+    z3::solver solver;
+    z3::expr i, j, res;
+    z3::expr_vector assumptions;    // the case literal in a family
+};
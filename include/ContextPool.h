@@ -0,0 +1,21 @@
+#pragma once
+
+#include "z3++.h"
+#include <string>
+
+// Setting up a z3::context costs about as much as solving one of the small
+// queries the rules make, so each thread keeps one and hands it from rule
+// to rule. Nothing of a rule outlives it in the context: every rule builds
+// its own solvers, and expressions are freed once the rule drops them.
+
+// the context for the rule running on this thread
+z3::context &rule_context();
+
+// retires every thread's context, each builds a fresh one when it next
+// asks, so settings made with z3::set_param reach the solvers of later rules
+void reset_rule_contexts();
+
+// context.int_const(name) and context.bv_const(name, bits), looked up once
+// per pooled context for the names the rules keep asking for
+z3::expr int_symbol(z3::context &context, const std::string &name);
+z3::expr bv_symbol(z3::context &context, const std::string &name, unsigned bits);
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "z3++.h"
+#include <iostream>
+#include <memory>
+
+#include "Cache.h"
+#include "Check.h"
+
+// Many rules build the same query, up to names and the direction of
+// comparisons: lt and gt are mirror images, and the bug checks repeat
+// queries of checks/. The same rule at another width is another query.
+// Widths never collide: the canonical text declares the sort of every
+// constant. Within a run each canonical form (see Cache.h) is solved
+// once, by the first rule to get there, and every other rule takes its
+// verdict, waiting for it if it is still being solved.
+class SharedQuery {
+public:
+    explicit SharedQuery(const CanonicalQuery &query);
+    // an owner that never published leaves the query to the next asker
+    ~SharedQuery();
+    SharedQuery(const SharedQuery &) = delete;
+    SharedQuery &operator=(const SharedQuery &) = delete;
+
+    // True, with result filled in, if another rule answered this query in
+    // this run. False if this one is the first and must solve it, or if
+    // the answer cannot be carried over (a model with functions in it).
+    bool Answered(z3::context &context, CheckResult &result);
+    // hands this rule's answer to the others, once it has one
+    void Publish(const CheckResult &result);
+
+    struct Entry;
+
+private:
+    const CanonicalQuery &query;
+    std::shared_ptr<Entry> entry;
+    bool owner = false;
+};
+
+struct DedupTally {
+    unsigned queries = 0, shared = 0;
+    double solver_seconds = 0;  // the time the shared ones took to solve
+};
+
+DedupTally dedup_tally();
+
+// one line on how many queries were shared, after the run
+void print_dedup_summary(std::ostream &out);
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "z3++.h"
+#include <iostream>
+#include <optional>
+
+#include "Check.h"
+
+// Restates a bit-vector query over the integers. Every bit-vector term of
+// width w becomes its unsigned value, an integer in [0, 2^w): arithmetic
+// wraps with mod 2^w, signed comparisons compare the two's complement
+// reading, and shifts, extracts and extensions are multiplications and
+// divisions by powers of two. &, | and ^ have no integer counterpart, so
+// each becomes a fresh integer constrained only by facts that hold for it
+// (a | b >= a, a & b <= a, ...).
+//
+// The integer query has every model the bit-vector one has and maybe more,
+// so its unsat proves the bit-vector query unsat, and nothing else can be
+// concluded from it. Returns nothing for queries with terms it cannot
+// translate (division, overflow predicates, ...).
+std::optional<z3::expr_vector> integer_abstraction(const z3::expr_vector &assertions,
+                                                    const z3::expr_vector &assumptions);
+
+// Tries the integer abstraction of a QF_BV query first, within
+// solve_options().dual_budget_ms. Returns true with result filled in if it
+// proved the query, false if the query has to be solved as bit-vectors.
+bool solve_integer_first(z3::solver &solver, const z3::expr_vector &assumptions, CheckResult &result);
+
+// Counts which theory closed each bit-vector query, across all threads.
+// A query goes to the bit-vector solver if it cannot be translated, or if
+// the integers could not prove it; the time they took is then wasted.
+struct DualTally {
+    unsigned queries = 0, by_integers = 0, untranslated = 0;
+    double integer_seconds = 0;     // in integer proofs
+    double wasted_seconds = 0;      // in integer attempts that fell back
+    // with solve_options().dual_savings, the time bit-vectors took on the
+    // queries the integers proved
+    unsigned measured = 0;
+    double bitvector_seconds = 0;
+};
+
+DualTally dual_tally();
+
+// one paragraph on how the dual mode did, after the run
+void print_dual_summary(std::ostream &out);
@@ -1,15 +1,18 @@
 #pragma once
 
 #include "z3++.h"
+#include "Check.h"
+#include "ContextPool.h"
 #include "Interval.h"
+#include "Registry.h"
 
 template<typename BinaryPredicate>
-void check_equality_type(Interval *a, Interval *b,
+CheckResult check_equality_type(const Interval &a, const Interval &b,
                 z3::solver &solver, z3::context &context,
                 z3::expr &emin, z3::expr &emax,
                 BinaryPredicate &pred) {
-    z3::expr i = context.int_const("i");
-    z3::expr j = context.int_const("j");
+    z3::expr i = int_symbol(context, "i");
+    z3::expr j = int_symbol(context, "j");
     apply_interval(solver, a, i);
     apply_interval(solver, b, j);
 
@@ -18,36 +21,27 @@ void check_equality_type(Interval *a, Interval *b,
     // we want res to be neither of them (this would prove the rule false)
     solver.add(res != emin && res != emax);
     
-    z3::check_result ans = solver.check();
-    if(ans == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (ans == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
+    CheckResult result = solve(solver, [=](std::ostream &out, z3::model &model) {
+        out << "[" << model.eval(a.GetLower()) << ", " << model.eval(a.GetUpper()) << "]" << std::endl;
+        out << "[" << model.eval(b.GetLower()) << ", " << model.eval(b.GetUpper()) << "]" << std::endl;
 
-        std::cout << "[" << model.eval(a->GetLower()) << ", " << model.eval(a->GetUpper()) << "]" << std::endl;
-        std::cout << "[" << model.eval(b->GetLower()) << ", " << model.eval(b->GetUpper()) << "]" << std::endl;
+        out << "Resultant bounds: [";
+        out << model.eval(emin) << ", " << model.eval(emax);
+        out << "]" << std::endl;
 
-        std::cout << "Resultant bounds: [";
-        std::cout << model.eval(emin) << ", " << model.eval(emax);
-        std::cout << "]" << std::endl;
-
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(i) << pred.str << model.eval(j) << " is " << model.eval(res) << std::endl;
-    }
-    delete a;
-    delete b;
+        out << "Contradiction: ";
+        out << model.eval(i) << pred.str << model.eval(j) << " is " << model.eval(res) << std::endl;
+    });
+    return result;
 }
 
 template<typename BinaryPredicate>
-void check_equality_case(Interval *a, Interval *b,
+CheckResult check_equality_case(const Interval &a, const Interval &b,
                 z3::solver &solver, z3::context &context,
                 z3::expr &emin, z3::expr &emax,
                 BinaryPredicate &pred) {
-    z3::expr i = context.int_const("i");
-    z3::expr j = context.int_const("j");
+    z3::expr i = int_symbol(context, "i");
+    z3::expr j = int_symbol(context, "j");
     apply_interval(solver, a, i);
     apply_interval(solver, b, j);
 
@@ -56,23 +50,16 @@ void check_equality_case(Interval *a, Interval *b,
     // we want res to be neither of them (this would prove the rule false)
     solver.add(emin && !emax);
     
-    z3::check_result ans = solver.check();
-    if(ans == z3::unsat) {
-        std::cout << "proved" << std::endl;
-    } else if (ans == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        std::cout << "[" << model.eval(a->GetLower()) << ", " << model.eval(a->GetUpper()) << "]" << std::endl;
-        std::cout << "[" << model.eval(b->GetLower()) << ", " << model.eval(b->GetUpper()) << "]" << std::endl;
+    CheckResult result = solve(solver, [=](std::ostream &out, z3::model &model) {
+        out << "[" << model.eval(a.GetLower()) << ", " << model.eval(a.GetUpper()) << "]" << std::endl;
+        out << "[" << model.eval(b.GetLower()) << ", " << model.eval(b.GetUpper()) << "]" << std::endl;
 
-        std::cout << "Resultant bounds: [";
-        std::cout << model.eval(emin) << ", " << model.eval(emax);
-        std::cout << "]" << std::endl;
+        out << "Resultant bounds: [";
+        out << model.eval(emin) << ", " << model.eval(emax);
+        out << "]" << std::endl;
 
-        // std::cout << "Contradiction: ";
-        // std::cout << model.eval(i) << pred.str << model.eval(j) << " is " << model.eval(res) << std::endl;
-    }
+        // out << "Contradiction: ";
+        // out << model.eval(i) << pred.str << model.eval(j) << " is " << model.eval(res) << std::endl;
+    });
+    return result;
 }
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Registry.h"
+
+// An engine that decides 8-bit rules for binary bit-vector operators without
+// z3, by trying every operand interval. Values are ints in the range of
+// their type, -128..127 for Int(8) and 0..255 for UInt(8).
+
+// The semantics of Operations.h on 8 bits, bit for bit as z3 sees them:
+// shift amounts are unsigned, shifting by 8 or more gives 0 (the sign for
+// an arithmetic shift), and "b < 0" is a signed comparison.
+inline int bits8(int value) {
+    return value & 0xff;
+}
+
+inline int value8(int bits, bool is_signed) {
+    bits &= 0xff;
+    return (is_signed && bits >= 128) ? bits - 256 : bits;
+}
+
+inline int shl8(int a, int s) {
+    return (bits8(s) >= 8) ? 0 : bits8(bits8(a) << bits8(s));
+}
+
+inline int lshr8(int a, int s) {
+    return (bits8(s) >= 8) ? 0 : bits8(a) >> bits8(s);
+}
+
+inline int ashr8(int a, int s) {
+    int v = value8(a, true);
+    return bits8((bits8(s) >= 8) ? (v < 0 ? -1 : 0) : v >> bits8(s));
+}
+
+// left_shift() and the right shifts, the result in the type of a
+int left_shift8(int a, int b, bool aIsUint, bool bIsUint);
+int right_shift8(int a, int b, bool aIsUint, bool bIsUint);
+
+// the pairs disallow_overflow() rules out in checks/shift_left.cpp and
+// checks/shift_right.cpp
+bool left_shift_overflows8(int i, int j, int res, bool iIsUint, bool jIsUint);
+bool right_shift_overflows8(int i, int j, int res, bool aIsUint);
+
+enum BoundedEnds {
+    LowerEnd = 1,
+    UpperEnd = 2,
+    BothEnds = LowerEnd | UpperEnd
+};
+
+// i op j in the type of a, false if the rule rules the pair out
+typedef bool (*PairFunction)(int i, int j, int &res);
+
+// false if the rule does not apply to these operand bounds, otherwise the
+// claimed bounds of the result; unbounded operand ends are passed as the
+// type's extremes
+typedef bool (*BoundFunction)(int a0, int a1, int b0, int b1, int &lo, int &hi);
+
+struct ExhaustiveRule {
+    bool a_signed;
+    BoundedEnds a_ends;
+    bool b_signed;
+    BoundedEnds b_ends;
+    PairFunction op;
+    BoundFunction bound;
+    BoundedEnds result_ends;
+    std::string op_name;    // for counterexamples, e.g. ">>"
+};
+
+// check_shift_left() and check_shift_right() for every signedness, pairs
+// with an out of range shift amount or that overflow are ruled out
+template<bool ASigned, bool BSigned>
+bool shift_left8(int i, int j, int &res) {
+    if (value8(j, true) >= 8) {
+        return false;
+    }
+    res = left_shift8(i, j, !ASigned, !BSigned);
+    return !left_shift_overflows8(i, j, res, !ASigned, !BSigned);
+}
+
+template<bool ASigned, bool BSigned>
+bool shift_right8(int i, int j, int &res) {
+    if (BSigned ? (j >= 8 || j <= -8) : (j >= 8)) {
+        return false;
+    }
+    res = right_shift8(i, j, !ASigned, !BSigned);
+    return !BSigned || !right_shift_overflows8(i, j, res, !ASigned);
+}
+
+template<bool Signed>
+bool bitwise_and8(int i, int j, int &res) {
+    res = value8(i & j, Signed);
+    return true;
+}
+
+template<bool Signed>
+bool bitwise_or8(int i, int j, int &res) {
+    res = value8(i | j, Signed);
+    return true;
+}
+
+struct ExhaustiveResult {
+    bool sound = true;
+    // operand bounds the rule applied to that hold at least one pair
+    uint64_t bounds = 0;
+    // the first counterexample, when not sound
+    int a0 = 0, a1 = 0, b0 = 0, b1 = 0, lo = 0, hi = 0;
+    int i = 0, j = 0, res = 0;
+    // Whether each bounded end of the result is attained for all operand
+    // bounds, and the first bounds where one is not, with the least and
+    // greatest result there. Only meaningful when sound.
+    bool lower_tight = true, upper_tight = true;
+    int loose_a0 = 0, loose_a1 = 0, loose_b0 = 0, loose_b1 = 0, loose_lo = 0, loose_hi = 0;
+    int least = 0, greatest = 0;
+    double seconds = 0;
+};
+
+// tries every interval of a and of b
+ExhaustiveResult check_exhaustive(const ExhaustiveRule &rule);
+
+// the exhaustive twin of each rule of a checks/ file that has one, by test
+// name, registered at static initialization like RuleGroup
+struct ExhaustiveGroup {
+    ExhaustiveGroup(const std::string &group,
+                    std::initializer_list<std::pair<std::string, ExhaustiveRule>> entries);
+};
+
+// by rule name, e.g. "shift_left/lower_bound_lshift_nonneg"
+std::map<std::string, ExhaustiveRule> &exhaustive_rules();
+
+// Checks every rule among rules that has an exhaustive twin, `jobs` at a
+// time, and prints one verdict per rule in rule order.
+void run_exhaustive(const std::vector<const Rule *> &rules, unsigned jobs);
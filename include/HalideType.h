@@ -0,0 +1,58 @@
+#pragma once
+
+#include "z3++.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// How a check at some width models the Halide type of that width. Rules
+// are mostly checked narrower than the Int(32) they are about, and then
+// stand in for it, overflow semantics included.
+enum TypeSemantics {
+    // every signed width leaves overflow undefined, as Int(32) does
+    ScaledTypes = 0,
+    // each width is its own Halide type: Int(8) and Int(16) wrap
+    ExactTypes
+};
+
+void set_type_semantics(TypeSemantics semantics);
+TypeSemantics type_semantics();
+
+std::string TypeSemanticsToString(TypeSemantics semantics);
+
+// A Halide scalar type, Int(bits) or UInt(bits), as a bit-vector sort and
+// the operations that depend on its signedness and overflow semantics.
+struct HalideType {
+    bool is_signed = true;
+    unsigned bits = 32;
+
+    static HalideType Int(unsigned bits) { return {true, bits}; }
+    static HalideType UInt(unsigned bits) { return {false, bits}; }
+
+    // "Int(32)", "UInt(8)"
+    std::string Name() const;
+
+    // Halide only leaves overflow of Int(32) and Int(64) undefined, the
+    // rest wraps. Under ScaledTypes, every Int(n) stands in for Int(32).
+    bool OverflowIsUndefined() const;
+
+    z3::expr Variable(z3::context &context, const std::string &name) const;
+    z3::expr Value(z3::context &context, int64_t value) const;
+
+    // comparisons, min and max in this type's signedness
+    z3::expr LessEqual(const z3::expr &a, const z3::expr &b) const;
+    z3::expr Less(const z3::expr &a, const z3::expr &b) const;
+    z3::expr Min(const z3::expr &a, const z3::expr &b) const;
+    z3::expr Max(const z3::expr &a, const z3::expr &b) const;
+
+    bool operator==(const HalideType &other) const {
+        return is_signed == other.is_signed && bits == other.bits;
+    }
+};
+
+// the type of a bit-vector value in the given signedness
+HalideType type_of(const z3::expr &value, bool is_signed);
+
+// Int and UInt of 8, 16, 32 and 64 bits, the types bounds inference has to
+// be right for
+const std::vector<HalideType> &production_types();
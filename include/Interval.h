@@ -3,6 +3,7 @@
 #include "Bound.h"
 #include "z3++.h"
 #include <string>
+#include <utility>
 
 enum IntervalType {
     Unknown = 0,
@@ -11,17 +12,18 @@ enum IntervalType {
 };
 
 
+// A plain value: the bounds are held in place, so an interval lives on
+// the stack of the rule that makes it, and sessions and checkers only
+// borrow it.
 struct Interval {
-    Bound *upper, *lower;
     IntervalType type;
-    Interval(IntervalType _type, Bound *_lower, Bound *_upper)
-        : type(_type), lower(_lower), upper(_upper) {}
-    Interval() : upper(nullptr), lower(nullptr) {}
-    ~Interval() { delete upper; delete lower; }
-    std::string ToString(z3::model &m);
-    std::string ToStringSymbolic();
-    z3::expr &GetLower();
-    z3::expr &GetUpper();
+    Bound lower, upper;
+    Interval(IntervalType _type, Bound _lower, Bound _upper)
+        : type(_type), lower(std::move(_lower)), upper(std::move(_upper)) {}
+    std::string ToString(z3::model &m) const;
+    std::string ToStringSymbolic() const;
+    const z3::expr &GetLower() const { return lower.expr; }
+    const z3::expr &GetUpper() const { return upper.expr; }
 };
 
 struct Bool_Interval {
@@ -30,10 +32,10 @@ struct Bool_Interval {
     Bool_Interval(std::string name, z3::context &context, z3::solver &solver);
 };
 
-void apply_interval(z3::solver &solver, Interval *interval, z3::expr &variable);
+void apply_interval(z3::solver &solver, const Interval &interval, const z3::expr &variable);
 
 
-Interval *MakeInterval(z3::context &context, std::string name, IntervalType type, 
+Interval MakeInterval(z3::context &context, std::string name, IntervalType type, 
                         Restriction lrest, BoundType ltype,
                         Restriction urest, BoundType utype);
 
@@ -43,7 +45,7 @@ struct ShiftParams {
     bool isUint = false;
     const z3::expr &upper;
     const z3::expr &lower;
-    std::string toString(z3::model &model) {
+    std::string toString(z3::model &model) const {
         std::string s = (isUint) ? "u" : "";
         s += "[";
         if (isLowerBounded) {
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "z3++.h"
+#include <string>
+
+// the fragment of first-order logic a query falls into
+enum Logic {
+    Propositional = 0,
+    QF_LIA,
+    QF_NIA,
+    QF_BV,
+    MixedLogic      // anything else, e.g. bit-vectors mixed with integers
+};
+
+std::string LogicToString(Logic logic);
+
+// looks at every term of the assertions and assumptions
+Logic classify_query(const z3::expr_vector &assertions, const z3::expr_vector &assumptions);
+
+// A named way of solving a query: a tactic pipeline, its tactics separated
+// by spaces, or an empty pipeline for a plain z3::solver.
+struct Strategy {
+    std::string name;
+    std::string tactic;
+};
+
+// the tuned pipeline for queries in the given logic
+Strategy logic_strategy(Logic logic);
+
+z3::tactic make_tactic(z3::context &context, const std::string &pipeline);
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "z3++.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Bit-vector semantics over the integers, for a width w that is itself a
+// variable in [min_width, max_width], so one query covers every width at
+// once. A w-bit value is its unsigned reading, an integer in [0, 2^w).
+//
+// 2^k for symbolic k is an uninterpreted function, constrained only by
+// facts that hold for every k (2^x < 2^y for x < y, 2^x divides 2^y, ...).
+// The integer query therefore has a model for every counterexample at
+// every width in range, and maybe more: its unsat proves the query at
+// every width, anything else says nothing.
+class ModularWidth {
+public:
+    ModularWidth(z3::context &context, unsigned min_width, unsigned max_width);
+
+    z3::context &Context() const { return context; }
+
+    // a fresh w-bit value
+    z3::expr Variable(const std::string &name);
+    // value at width w, negative values in two's complement
+    z3::expr Value(int64_t value);
+    // w as a w-bit value
+    z3::expr Width() const { return w; }
+
+    // 2^k
+    z3::expr Power(const z3::expr &k);
+    // the two's complement reading of a
+    z3::expr Signed(const z3::expr &a) const;
+    // x mod 2^w
+    z3::expr Wrap(const z3::expr &x);
+
+    // comparisons in either signedness
+    z3::expr LessEqual(bool is_signed, const z3::expr &a, const z3::expr &b) const;
+    z3::expr Less(bool is_signed, const z3::expr &a, const z3::expr &b) const;
+
+    // z3's bit-vector operators at width w, shift amounts read unsigned
+    z3::expr Negate(const z3::expr &a);
+    z3::expr Multiply(const z3::expr &a, const z3::expr &b);
+    z3::expr Shl(const z3::expr &a, const z3::expr &b);
+    z3::expr Lshr(const z3::expr &a, const z3::expr &b);
+    z3::expr Ashr(const z3::expr &a, const z3::expr &b);
+    // & and | are only known to lie within bounds of their operands
+    z3::expr BitAnd(const z3::expr &a, const z3::expr &b);
+    z3::expr BitOr(const z3::expr &a, const z3::expr &b);
+    z3::expr BitNot(const z3::expr &a) const;
+
+    // left_shift() and right_shift() of Operations.h
+    z3::expr LeftShift(const z3::expr &a, const z3::expr &b, bool aIsUint, bool bIsUint);
+    z3::expr RightShift(const z3::expr &a, const z3::expr &b, bool aIsUint, bool bIsUint);
+
+    // does Int(w) leave overflow undefined, under the type semantics
+    z3::expr SignedOverflowIsUndefined() const;
+
+    // shl_drops_bits(), left_shift_overflows() and right_shift_overflows()
+    // of Overflow.h, whatever the overflow encoding
+    z3::expr ShlDropsBits(const z3::expr &a, const z3::expr &b);
+    z3::expr LeftShiftOverflows(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool iIsUint,
+                                bool jIsUint);
+    z3::expr RightShiftOverflows(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool aIsUint);
+
+    // The range of w and of every variable, what is known of every power
+    // of two used so far, and of every & and |. Add them after the query
+    // is built.
+    z3::expr_vector Facts();
+
+private:
+    // wide_shl() of Overflow.h, i << j in 2w bits, as a signed integer
+    z3::expr WideShl(const z3::expr &i, const z3::expr &j);
+    z3::expr Fresh(const std::string &name);
+
+    // x * 2^k, x / 2^k and x mod 2^w, built through these so Facts() can
+    // state how they grow with x and k
+    z3::expr Product(const z3::expr &x, const z3::expr &k);
+    z3::expr Quotient(const z3::expr &x, const z3::expr &k);
+
+    // x op 2^k, for the lemmas about it
+    struct Scaled {
+        z3::expr x, power, term;
+    };
+
+    z3::context &context;
+    z3::func_decl power;
+    z3::expr w, modulus, half;
+    z3::expr_vector facts;
+    // the arguments power was applied to
+    std::vector<z3::expr> exponents;
+    std::vector<Scaled> products, quotients;
+    std::vector<std::pair<z3::expr, z3::expr>> wraps;   // x and x mod 2^w
+    unsigned fresh = 0;
+};
@@ -3,6 +3,8 @@
 #include "z3++.h"
 #include <string>
 
+#include "ShiftEncoding.h"
+
 enum Operation {
     Add = 0,
     Sub,
@@ -15,6 +17,16 @@ enum Operation {
 
 std::string OpToString(Operation op);
 
+// Whether a z3 operator is commutative (a op b == b op a). Add, Mul and
+// the bitwise and boolean operators lower to these: +, *, =, and, or, xor
+// and their bit-vector forms. Min and Max lower to ite, see is_min_max().
+bool is_commutative(Z3_decl_kind kind);
+
+// ite(p < q, p, q) or ite(p < q, q, p), with <= or a bit-vector comparison
+// just as well: min and max as z3::min() and z3::max() build them, once
+// their >= is turned around
+bool is_min_max(const z3::expr &e);
+
 z3::expr generate_op(Operation op, z3::expr &i, z3::expr &j);
 
 // i / j in Halide semantics (i / 0 == 0)
@@ -43,8 +55,12 @@ inline z3::expr int_shift_left(const z3::expr &a, const z3::expr &b) {
     return z3::ite(b < 0, z3::ashr(a, b * -1), ite(a >= 0, z3::shl(a, b), a * z3::shl(1, b)));
 }
 
+// the shift under test, in the encoding chosen for the type of a
 inline z3::expr left_shift(const z3::expr &a, const z3::expr &b, bool aIsUint, bool bIsUint) {
-    if (aIsUint && bIsUint) {
+    ShiftEncoding encoding = shift_encoding(type_of(a, !aIsUint));
+    if (encoding != BarrelShift) {
+        return encoded_shift(a, b, /* left */true, aIsUint, bIsUint, encoding);
+    } else if (aIsUint && bIsUint) {
         return uint_shift_left(a, b);
     } else if (!aIsUint && bIsUint) {
         return iu_shift_left(a, b);
@@ -79,6 +95,22 @@ inline z3::expr int_shift_right(const z3::expr &a, const z3::expr &b) {
     return z3::ite(b < 0, z3::shl(a, -1 * b), z3::ashr(a, b));
 }
 
+inline z3::expr right_shift(const z3::expr &a, const z3::expr &b, bool aIsUint, bool bIsUint) {
+    ShiftEncoding encoding = shift_encoding(type_of(a, !aIsUint));
+    if (encoding != BarrelShift) {
+        return encoded_shift(a, b, /* left */false, aIsUint, bIsUint, encoding);
+    } else if (aIsUint && bIsUint) {
+        return uint_shift_right(a, b);
+    } else if (!aIsUint && bIsUint) {
+        return mixed_iu_shift_right(a, b);
+    } else if (aIsUint && !bIsUint) {
+        return mixed_ui_shift_right(a, b);
+    } else {
+        // !aIsUint && !bIsUint
+        return int_shift_right(a, b);
+    }
+}
+
 inline z3::expr count_set_bits(const z3::expr &i, size_t bits) {
     z3::expr count = i.ctx().bv_val(0, bits);
     z3::expr temp = i;
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "z3++.h"
+#include <string>
+
+// How the rules tell whether a shift lost bits. They all mean the same
+// thing; they only differ in the size of the query and how fast z3 solves
+// it.
+enum OverflowEncoding {
+    // popcount(a) != popcount(a << b), each count an adder chain as deep
+    // as the width (the original encoding)
+    CountSetBits = 0,
+    // (a << b) >> b != a, which shares a << b with the result
+    ShiftBack,
+    // z3's own multiplication overflow predicate on a * (1 << b)
+    MulNoOverflow
+};
+
+void set_overflow_encoding(OverflowEncoding encoding);
+OverflowEncoding overflow_encoding();
+
+std::string OverflowEncodingToString(OverflowEncoding encoding);
+// false if name is not one of the above
+bool ParseOverflowEncoding(const std::string &name, OverflowEncoding &encoding);
+
+// Does a << b, with b taken unsigned, drop set bits off the top? Shifting
+// by the width or more drops every bit.
+z3::expr shl_drops_bits(const z3::expr &a, const z3::expr &b);
+
+// a << b in twice the width of a, both sign extended, so nothing is lost
+z3::expr wide_shl(const z3::expr &a, const z3::expr &b);
+
+// Does i << j overflow, in the sense the shift_left rules exclude? res must
+// be i << j wherever j >= 0, which left_shift() gives.
+z3::expr left_shift_overflows(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool iIsUint,
+                                bool jIsUint);
+
+// Does i >> j overflow? Only a negative j, which shifts left, can; res must
+// be i << -j there, which right_shift() gives.
+z3::expr right_shift_overflows(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool aIsUint);
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "z3++.h"
+#include <string>
+#include <vector>
+
+#include "Check.h"
+#include "Logic.h"
+
+// default (the query's own solver, checked in place), qfnia, nlsat and bit-blasting over a bounded domain
+const std::vector<Strategy> &portfolio_strategies();
+
+// Races every strategy on the query, each on its own thread and all but the
+// first in a translated context, and interrupts the rest as soon as one of
+// them answers sat or unsat. Fills in status, reason_unknown, model (in the
+// query's context) and solved_by.
+CheckResult solve_portfolio(z3::solver &solver, const z3::expr_vector &assumptions);
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <initializer_list>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace z3 {
+    class context;
+}
+
+typedef void (*RuleFunction)();
+
+// a rule that builds its queries in the context it is handed, so the rules
+// of one group can be run as a family sharing one solver (see Family)
+typedef void (*FamilyRuleFunction)(z3::context &context);
+
+// a bit-vector rule instantiated at each width it can be checked at
+typedef std::vector<std::pair<unsigned, RuleFunction>> WidthFunctions;
+
+struct Rule {
+    std::string name;   // <group>/<test>, e.g. "mul/b_zero"
+    std::string op;     // operator under test, e.g. "mul" or "shift_right"
+    std::vector<std::string> tags;
+    RuleFunction function = nullptr;
+    FamilyRuleFunction family_function = nullptr;
+    std::string family; // the group, for family rules
+    std::string file;   // the source file the rule is defined in
+    std::string function_name;
+    unsigned width = 0;     // the width function checks at, for bit-vector rules
+    WidthFunctions widths;  // the rule at every width, for bit-vector rules
+    bool HasTag(const std::string &tag) const;
+    // runs the rule on its own, a family rule in a fresh context
+    void Run() const;
+};
+
+// one entry in a RuleGroup initializer list, use RULE(fn, tags...) to build
+struct RuleEntry {
+    RuleEntry(const char *function_name, RuleFunction function, std::vector<std::string> tags,
+                const char *file);
+    RuleEntry(const char *function_name, FamilyRuleFunction function, std::vector<std::string> tags,
+                const char *file);
+    RuleEntry(const char *function_name, WidthFunctions widths, unsigned width, std::vector<std::string> tags,
+                const char *file);
+    const char *function_name;
+    const char *file;
+    RuleFunction function = nullptr;
+    FamilyRuleFunction family_function = nullptr;
+    std::vector<std::string> tags;
+    unsigned width = 0;
+    WidthFunctions widths;
+};
+
+#define RULE(fn, ...) RuleEntry{#fn, fn, {__VA_ARGS__}, __FILE__}
+
+// the widths every bit-vector rule is instantiated at
+#define BV_WIDTHS(fn) WidthFunctions{{4, fn<4>}, {8, fn<8>}, {16, fn<16>}, {32, fn<32>}, {64, fn<64>}}
+
+// RULE for a bit-vector rule templated on its width, run at width bits
+#define BV_RULE(fn, width, ...) RuleEntry{#fn, BV_WIDTHS(fn), width, {__VA_ARGS__}, __FILE__}
+
+// Registers every rule of a checks/ or bugs/ file at static initialization.
+// Rules keep the order they are listed in, which is the order they run in.
+struct RuleGroup {
+    RuleGroup(std::string group, std::string op, std::vector<std::string> tags,
+                std::initializer_list<RuleEntry> entries);
+};
+
+// rules tagged "disabled" are only run when asked for explicitly
+struct RuleFilter {
+    std::vector<std::string> ops;
+    std::vector<std::string> tags;
+    std::vector<std::string> globs;
+    bool include_disabled = false;
+    bool Matches(const Rule &rule) const;
+};
+
+std::vector<Rule> &all_rules();
+
+std::vector<const Rule *> select_rules(const RuleFilter &filter);
+
+// where the rule running on this thread writes its report, std::cout unless
+// a runner has redirected it
+std::ostream &rule_output();
+
+// redirects rule_output() for this thread, returns the previous stream
+std::ostream *set_rule_output(std::ostream *output);
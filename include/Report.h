@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Check.h"
+
+// Prints results to rule_output(). Checkers only compute results, so the
+// format of the report lives here alone.
+
+// "proved", "failed to prove" or "ERROR: ...", then the statement or the
+// counterexample
+void report(const CheckResult &result);
+
+// " Tight.", " NOT tight." or " Unknown (...)." after a "Checking ..." line
+void report_tightness(const CheckResult &result);
+
+// "Checking lower/upper bound tightness..." for each bounded end
+void report(const TightnessResult &result);
+
+// the verdicts and solver time reported on one thread
+struct ReportTally {
+    unsigned proved = 0, failed = 0, unknown = 0;
+    double seconds = 0;             // including tightness queries
+    std::string reason_unknown;     // of the first unknown
+};
+
+// adds every report made on this thread to tally, until it is set to
+// nullptr; returns the previous tally
+ReportTally *set_report_tally(ReportTally *tally);
+
+// appends the time spent in the solver to every verdict, next to the
+// query's logic and the strategy that answered if they are known
+void set_report_timing(bool enabled);
+bool report_timing();
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "z3++.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Registry.h"
+
+// Fixed set of worker threads taking tasks from one queue. The
+// destructor waits for every task to finish.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads);
+    ~ThreadPool();
+
+    void Submit(std::function<void()> task);
+
+private:
+    void Work();
+    bool RunOne(std::unique_lock<std::mutex> &lock);
+
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool stopping = false;
+};
+
+// How to run the rules. Zero limits mean unlimited.
+struct RunOptions {
+    // per-query budget, enforced by z3 itself (the "timeout" parameter)
+    unsigned query_timeout_ms = 0;
+    // per-rule wall clock and address space caps, only enforceable when
+    // each rule runs in its own process
+    unsigned rule_timeout_s = 0;
+    unsigned memory_mb = 0;
+    bool isolate = false;
+    // run consecutive rules of one family against a single solver
+    bool families = false;
+    // where each rule's report is recorded along with a fingerprint of its
+    // sources, empty to record nothing
+    std::string results_dir;
+    // replay the recorded report of every rule whose fingerprint is
+    // unchanged, only run the others
+    bool only_changed = false;
+};
+
+// Runs the rules on `jobs` threads, each with its output buffered and
+// written to std::cout in rule order, so the report reads exactly as a
+// serial run does. With jobs <= 1 the rules run in order on this thread.
+//
+// With options.families, the selected rules of a family run together on one
+// thread, sharing a Family and with it a single solver.
+//
+// With options.isolate, every rule instead runs in a forked worker process,
+// at most `jobs` at a time. A worker that outlives options.rule_timeout_s is
+// killed, and options.memory_mb caps its address space, so a runaway rule
+// is reported as such instead of stalling or taking down the whole run.
+// Families are not batched then, each rule keeps its own limits.
+//
+// With options.only_changed, rules whose sources are unchanged since their
+// report was recorded in options.results_dir are not run, their recorded
+// report is printed in their place.
+void run_rules(const std::vector<const Rule *> &rules, unsigned jobs,
+                const RunOptions &options = RunOptions());
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "z3++.h"
+#include <string>
+
+#include "HalideType.h"
+
+// How left_shift() and right_shift() build a shift for z3. They all mean
+// the same thing for every shift amount; they only differ in what the
+// query looks like once bit-blasted. The rules only ever shift by less
+// than the width, so there are few amounts to tell apart.
+enum ShiftEncoding {
+    // z3's shl, lshr and ashr, a barrel shifter per shift, and
+    // ite(b < 0, ...) with -b for a signed amount (the original encoding)
+    BarrelShift = 0,
+    // an ite chain over the amounts below the width, each arm a shift by
+    // a constant, which is only wiring
+    AmountChain,
+    // a * 2^b and a / 2^b, 2^b picked from a table of constants
+    PowerTable,
+    // a signed amount split on its sign up front: one ite chain over every
+    // amount in (-width, width), each arm shifting its constant distance
+    // in the direction of its sign, so -b is never formed
+    SignSplit
+};
+
+// the encoding of every shift, or of the shifts of values of one type
+void set_shift_encoding(ShiftEncoding encoding);
+void set_shift_encoding(const HalideType &type, ShiftEncoding encoding);
+ShiftEncoding shift_encoding(const HalideType &type);
+
+std::string ShiftEncodingToString(ShiftEncoding encoding);
+// false if name is not one of the above
+bool ParseShiftEncoding(const std::string &name, ShiftEncoding &encoding);
+
+// "chain" sets every type, "Int(8)=chain,UInt(32)=mul" the types named;
+// false, having set nothing, if any part does not parse
+bool ParseShiftEncodings(const std::string &spec);
+// the encoding of every production type that does not use the default,
+// in the form ParseShiftEncodings() reads, e.g. "barrel" or "Int(8)=chain"
+std::string ShiftEncodingsToString();
+
+// a << b for left, a >> b otherwise, in the semantics of left_shift() and
+// right_shift() of Operations.h, built with the given encoding
+z3::expr encoded_shift(const z3::expr &a, const z3::expr &b, bool left, bool aIsUint, bool bIsUint,
+                        ShiftEncoding encoding);
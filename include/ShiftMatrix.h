@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Exhaustive.h"
+#include "Runner.h"
+
+// where [b0, b1] lies, as the shift rules require of it
+enum ShiftAmounts {
+    AmountsNonNegative = 0,    // 0 <= b0, b1 < width
+    AmountsNegative,           // -width < b0, b1 < 0, signed b only
+    AmountsEitherSign          // -width < b0, b1 < width, signed b only
+};
+
+// One generated shift rule: a op b with the result bounded by the corners,
+// min(a0 op b0, a0 op b1) below and max(a1 op b0, a1 op b1) above, for
+// whichever ends of a are bounded. The corners must not overflow.
+struct ShiftCase {
+    bool left;          // << or >>
+    bool a_signed, b_signed;
+    BoundedEnds a_ends;
+    ShiftAmounts b_amounts;
+
+    // e.g. "shift_right/uint_int/lower/negative"
+    std::string Name() const;
+};
+
+// every signedness x bounds x shift amount combination for << and >>
+std::vector<ShiftCase> shift_matrix();
+
+// Checks every case whose name matches one of globs (all of them if there
+// are none) at each width, all at once on `jobs` threads, then prints one
+// row per case with its verdict and solver time at each width, followed by
+// a counterexample for every case that failed, at its narrowest width.
+// A case that holds only because nothing meets its assumptions (the shift
+// amounts, corners that must not overflow) is reported vacuous, not pass.
+//
+// With a symbolic budget, each case is first tried for every width from
+// the narrowest to the widest at once (see Modular.h), for at most that
+// long, and only checked width by width if that does not prove it.
+void run_shift_matrix(const std::vector<std::string> &globs, const std::vector<unsigned> &widths, unsigned jobs,
+                        const RunOptions &run_options, unsigned symbolic_budget_ms = 0);
+
+// Checks every case matching globs at each width once in every shift
+// encoding (see ShiftEncoding.h), then prints the total solver time of each
+// encoding per type of a, which is what an encoding is picked for, and
+// the --shift-encoding that picks the fastest for every type. Cases that
+// time out count against an encoding before any time does.
+void run_shift_benchmark(const std::vector<std::string> &globs, const std::vector<unsigned> &widths, unsigned jobs,
+                            const RunOptions &run_options);
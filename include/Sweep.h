@@ -0,0 +1,35 @@
+#pragma once
+
+#include <vector>
+
+#include "Registry.h"
+#include "Runner.h"
+
+struct SweepOptions {
+    std::vector<unsigned> widths = {8, 16, 32, 64};
+    // flag rules whose solver time grows by more than this factor when the
+    // width doubles
+    double growth = 4;
+};
+
+// Runs every bit-vector rule among rules at each of options.widths, all at
+// once on `jobs` threads, then prints a table with the verdict and solver
+// time of each rule at each width, flagging steep growth, followed by the
+// reports of the runs that did not prove their rule. Rules that are not
+// bit-vector rules are skipped.
+void run_sweep(const std::vector<const Rule *> &rules, unsigned jobs, const RunOptions &run_options,
+                const SweepOptions &options);
+
+struct StagedOptions {
+    // cheap widths, checked in order, where most broken rules show
+    std::vector<unsigned> screen = {4, 8};
+    // the widths that matter, only for rules that survive screening
+    std::vector<unsigned> prove = {32, 64};
+};
+
+// Checks every bit-vector rule among rules at the screening widths first,
+// all rules before any proof, and stops a rule at its first counterexample.
+// Only rules that survive are checked at the proof widths. Each rule's
+// outcome is printed as soon as it is known, a refutation with its report.
+void run_staged(const std::vector<const Rule *> &rules, unsigned jobs, const RunOptions &run_options,
+                const StagedOptions &options);
@@ -1,6 +1,6 @@
 #include "Bound.h"
 
-std::string Bound::ToString(z3::model &m) {
+std::string Bound::ToString(z3::model &m) const {
     if (type == BoundType::Unbounded) {
         return "_";
     } else {
@@ -8,7 +8,7 @@ std::string Bound::ToString(z3::model &m) {
     }
 }
 
-std::string Bound::ToStringSymbolic(bool print) {
+std::string Bound::ToStringSymbolic(bool print) const {
     if (type == BoundType::Unbounded && !print) {
         return "_";
     }
@@ -38,17 +38,17 @@ std::string Bound::ToStringSymbolic(bool print) {
     }
 }
 
-void apply_bound(z3::solver &solver, z3::expr &variable, Bound *bound) {
-    switch(bound->type) {
+void apply_bound(z3::solver &solver, const z3::expr &variable, const Bound &bound) {
+    switch(bound.type) {
         case BoundType::Unbounded: {
             return;
         }
         case BoundType::UpperBound: {
-            solver.add(variable <= bound->expr);
+            solver.add(variable <= bound.expr);
             return;
         }
         case BoundType::LowerBound: {
-            solver.add(variable >= bound->expr);
+            solver.add(variable >= bound.expr);
             return;
         }
         default: {
@@ -57,29 +57,29 @@ void apply_bound(z3::solver &solver, z3::expr &variable, Bound *bound) {
     }
 }
 
-void apply_restriction(z3::solver &solver, Bound *bound) {
-    switch(bound->restriction) {
+void apply_restriction(z3::solver &solver, const Bound &bound) {
+    switch(bound.restriction) {
         case NoRestriction: {
             return;
         }
         case Restriction::Positive: {
-            solver.add(bound->expr > 0);
+            solver.add(bound.expr > 0);
             return;
         }
         case Restriction::Negative: {
-            solver.add(bound->expr < 0);
+            solver.add(bound.expr < 0);
             return;
         }
         case Restriction::NonPositive: {
-            solver.add(bound->expr <= 0);
+            solver.add(bound.expr <= 0);
             return;
         }
         case Restriction::NonNegative: {
-            solver.add(bound->expr >= 0);
+            solver.add(bound.expr >= 0);
             return;
         }
         case Restriction::IsZero: {
-            solver.add(bound->expr == 0);
+            solver.add(bound.expr == 0);
             return;
         }
         default: {
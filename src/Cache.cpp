@@ -0,0 +1,362 @@
+#include "Cache.h"
+#include "Operations.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <unistd.h>
+
+static const char *cache_header = "verify-bounds cache 2";
+
+static void collect_constants(const z3::expr &e, std::unordered_set<unsigned> &seen,
+                                std::vector<z3::expr> &constants) {
+    if (!seen.insert(e.id()).second || !e.is_app()) {
+        return;
+    }
+    if (e.num_args() == 0 && e.decl().decl_kind() == Z3_OP_UNINTERPRETED) {
+        constants.push_back(e);
+        return;
+    }
+    for (unsigned a = 0; a < e.num_args(); a++) {
+        collect_constants(e.arg(a), seen, constants);
+    }
+}
+
+static bool is_reversed_comparison(const z3::expr &e) {
+    if (!e.is_app()) {
+        return false;
+    }
+    switch (e.decl().decl_kind()) {
+        case Z3_OP_GT:
+        case Z3_OP_GE:
+        case Z3_OP_SGT:
+        case Z3_OP_SGEQ:
+        case Z3_OP_UGT:
+        case Z3_OP_UGEQ:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// a > b as b < a, and so on
+static z3::expr flipped(const z3::expr &e) {
+    z3::expr a = e.arg(0), b = e.arg(1);
+    switch (e.decl().decl_kind()) {
+        case Z3_OP_GT:
+        case Z3_OP_SGT:
+            return b < a;
+        case Z3_OP_GE:
+        case Z3_OP_SGEQ:
+            return b <= a;
+        case Z3_OP_UGT:
+            return z3::ult(b, a);
+        default:
+            return z3::ule(b, a);
+    }
+}
+
+static void collect_reversed(const z3::expr &e, std::unordered_set<unsigned> &seen, z3::expr_vector &reversed) {
+    if (!seen.insert(e.id()).second || !e.is_app()) {
+        return;
+    }
+    if (is_reversed_comparison(e)) {
+        reversed.push_back(e);
+    }
+    for (unsigned a = 0; a < e.num_args(); a++) {
+        collect_reversed(e.arg(a), seen, reversed);
+    }
+}
+
+// Every comparison written as < or <=, so a rule and its mirror image
+// (x > y where the other has y < x) read the same. A flipped comparison
+// keeps its operands as they were, so nested ones take another round.
+static z3::expr orient(z3::expr formula) {
+    while (true) {
+        std::unordered_set<unsigned> seen;
+        z3::expr_vector reversed(formula.ctx()), oriented(formula.ctx());
+        collect_reversed(formula, seen, reversed);
+        if (reversed.empty()) {
+            return formula;
+        }
+        for (unsigned r = 0; r < reversed.size(); r++) {
+            oriented.push_back(flipped(reversed[r]));
+        }
+        formula = formula.substitute(reversed, oriented);
+    }
+}
+
+static z3::expr sort_operands(const z3::expr &e, std::unordered_map<unsigned, z3::expr> &done) {
+    auto found = done.find(e.id());
+    if (found != done.end()) {
+        return found->second;
+    }
+    if (!e.is_app() || e.num_args() == 0) {
+        return e;
+    }
+    z3::expr_vector args(e.ctx());
+    for (unsigned a = 0; a < e.num_args(); a++) {
+        args.push_back(sort_operands(e.arg(a), done));
+    }
+    z3::expr sorted = e;
+    if (is_commutative(e.decl().decl_kind())) {
+        std::vector<std::pair<std::string, unsigned>> texts;
+        for (unsigned a = 0; a < args.size(); a++) {
+            texts.emplace_back(args[a].to_string(), a);
+        }
+        std::stable_sort(texts.begin(), texts.end());
+        z3::expr_vector ordered(e.ctx());
+        for (const auto &text : texts) {
+            ordered.push_back(args[text.second]);
+        }
+        sorted = e.decl()(ordered);
+    } else {
+        sorted = e.decl()(args);
+        if (is_min_max(sorted)) {
+            // min(p, q) is min(q, p): where p == q they pick different
+            // operands of the same value
+            z3::expr condition = sorted.arg(0);
+            z3::expr p = condition.arg(0), q = condition.arg(1);
+            if (q.to_string() < p.to_string()) {
+                bool is_min = z3::eq(sorted.arg(1), p);
+                z3::expr swapped = condition.decl()(q, p);
+                sorted = is_min ? z3::ite(swapped, q, p) : z3::ite(swapped, p, q);
+            }
+        }
+    }
+    done.emplace(e.id(), sorted);
+    return sorted;
+}
+
+// the text of e with the operands of every commutative operator, min and
+// max among them, in order of their text, so a op b reads as b op a does
+static std::string operand_sorted_text(const z3::expr &e) {
+    std::unordered_map<unsigned, z3::expr> done;
+    return sort_operands(e, done).to_string();
+}
+
+// 64-bit FNV-1a, stable across runs and builds unlike std::hash
+std::string hash_hex(const std::string &data) {
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : data) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    char hex[17];
+    snprintf(hex, sizeof(hex), "%016llx", (unsigned long long)hash);
+    return hex;
+}
+
+CanonicalQuery canonicalize(const z3::expr_vector &assertions, const z3::expr_vector &assumptions,
+                            const std::string &parameters) {
+    std::vector<z3::expr> formulas;
+    for (unsigned a = 0; a < assertions.size(); a++) {
+        formulas.push_back(orient(assertions[a]));
+    }
+    for (unsigned a = 0; a < assumptions.size(); a++) {
+        formulas.push_back(orient(assumptions[a]));
+    }
+
+    // sort by shape: every constant of a sort looks the same
+    std::vector<z3::expr> constants;
+    std::unordered_set<unsigned> seen;
+    for (const z3::expr &formula : formulas) {
+        collect_constants(formula, seen, constants);
+    }
+    z3::context &context = assertions.ctx();
+    z3::expr_vector from(context), blind(context);
+    for (const z3::expr &constant : constants) {
+        from.push_back(constant);
+        blind.push_back(context.constant("_", constant.get_sort()));
+    }
+    std::vector<std::pair<std::string, size_t>> shapes;
+    for (size_t f = 0; f < formulas.size(); f++) {
+        shapes.emplace_back(operand_sorted_text(formulas[f].substitute(from, blind)), f);
+    }
+    std::stable_sort(shapes.begin(), shapes.end(),
+                        [](const auto &x, const auto &y) { return x.first < y.first; });
+
+    // then order the constants by how they are used, the shapes of the
+    // formulas they are in with only them visible, so that constants
+    // playing the same part get the same name whatever they are called;
+    // ties keep the order of first use
+    std::vector<z3::expr> used;
+    seen.clear();
+    for (const auto &shape : shapes) {
+        collect_constants(formulas[shape.second], seen, used);
+    }
+    std::vector<std::vector<z3::expr>> in_formula(formulas.size());
+    for (size_t f = 0; f < formulas.size(); f++) {
+        seen.clear();
+        collect_constants(formulas[f], seen, in_formula[f]);
+    }
+    std::vector<std::pair<std::string, size_t>> roles;
+    for (size_t c = 0; c < used.size(); c++) {
+        z3::expr_vector marked(context);
+        for (const z3::expr &constant : constants) {
+            marked.push_back(context.constant(z3::eq(constant, used[c]) ? "*" : "_", constant.get_sort()));
+        }
+        std::vector<std::string> uses;
+        for (size_t f = 0; f < formulas.size(); f++) {
+            for (const z3::expr &constant : in_formula[f]) {
+                if (z3::eq(constant, used[c])) {
+                    uses.push_back(operand_sorted_text(formulas[f].substitute(from, marked)));
+                    break;
+                }
+            }
+        }
+        std::sort(uses.begin(), uses.end());
+        std::string role;
+        for (const std::string &use : uses) {
+            role += use + "\n";
+        }
+        roles.emplace_back(role, c);
+    }
+    std::stable_sort(roles.begin(), roles.end(), [](const auto &x, const auto &y) { return x.first < y.first; });
+
+    CanonicalQuery query;
+    z3::expr_vector original(context), renamed(context);
+    for (size_t r = 0; r < roles.size(); r++) {
+        const z3::expr &constant = used[roles[r].second];
+        std::string name = "v" + std::to_string(r);
+        query.constants.push_back(constant);
+        original.push_back(constant);
+        renamed.push_back(context.constant(name.c_str(), constant.get_sort()));
+    }
+    // the sorts first: the same formula at another width is another query
+    for (size_t r = 0; r < renamed.size(); r++) {
+        query.text += "(declare-const " + renamed[r].to_string() + " " + renamed[r].get_sort().to_string() + ")\n";
+    }
+    std::vector<std::string> texts;
+    for (z3::expr formula : formulas) {
+        texts.push_back(operand_sorted_text(formula.substitute(original, renamed)) + "\n");
+    }
+    std::sort(texts.begin(), texts.end());
+    for (const std::string &text : texts) {
+        query.text += text;
+    }
+
+    query.key = hash_hex(std::string(Z3_get_full_version()) + "\n" + parameters + "\n" + query.text);
+    return query;
+}
+
+bool model_values(const CanonicalQuery &query, const z3::model &model, std::vector<ConstantValue> &values) {
+    if (model.num_funcs() != 0) {
+        return false;
+    }
+    for (size_t c = 0; c < query.constants.size(); c++) {
+        z3::func_decl decl = query.constants[c].decl();
+        if (!model.has_interp(decl)) {
+            continue;
+        }
+        z3::expr interp = model.get_const_interp(decl);
+        std::string value;
+        if (interp.is_true() || interp.is_false()) {
+            value = interp.is_true() ? "true" : "false";
+        } else if (!interp.is_numeral(value) || interp.get_sort().is_real()) {
+            return false;
+        }
+        values.push_back({c, value});
+    }
+    return true;
+}
+
+z3::model model_from_values(const CanonicalQuery &query, z3::context &context,
+                            const std::vector<ConstantValue> &values) {
+    z3::model model(context);
+    for (const ConstantValue &value : values) {
+        z3::func_decl decl = query.constants[value.constant].decl();
+        z3::sort sort = query.constants[value.constant].get_sort();
+        z3::expr interp = sort.is_bool() ? context.bool_val(value.value == "true")
+                        : sort.is_bv() ? context.bv_val(value.value.c_str(), sort.bv_size())
+                        : context.int_val(value.value.c_str());
+        model.add_const_interp(decl, interp);
+    }
+    return model;
+}
+
+bool cache_load(const std::string &dir, const CanonicalQuery &query, z3::context &context,
+                CheckResult &result) {
+    std::ifstream in(dir + "/" + query.key);
+    std::string line, status;
+    size_t values = 0;
+    if (!std::getline(in, line) || line != cache_header ||
+            !(in >> line >> status) || line != "status" ||
+            !(in >> line >> values) || line != "model") {
+        return false;
+    }
+
+    std::vector<ConstantValue> model;
+    for (size_t v = 0; v < values; v++) {
+        ConstantValue value;
+        if (!(in >> value.constant >> value.value) || value.constant >= query.constants.size()) {
+            return false;
+        }
+        model.push_back(value);
+    }
+
+    // the hash only picks the file, the query itself has to match
+    std::getline(in, line);
+    if (!std::getline(in, line) || line != "query") {
+        return false;
+    }
+    std::ostringstream text;
+    text << in.rdbuf();
+    if (text.str() != query.text) {
+        return false;
+    }
+
+    if (status == "unsat") {
+        result.status = z3::unsat;
+    } else if (status == "sat") {
+        result.status = z3::sat;
+        result.model = model_from_values(query, context, model);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void cache_store(const std::string &dir, const CanonicalQuery &query, const CheckResult &result) {
+    std::ostringstream entry;
+    entry << cache_header << "\n";
+    std::vector<ConstantValue> values;
+    if (result.status == z3::sat) {
+        if (!model_values(query, *result.model, values)) {
+            return;
+        }
+        entry << "status sat\n";
+    } else if (result.status == z3::unsat) {
+        entry << "status unsat\n";
+    } else {
+        return;
+    }
+    entry << "model " << values.size() << "\n";
+    for (const ConstantValue &value : values) {
+        entry << value.constant << " " << value.value << "\n";
+    }
+    entry << "query\n" << query.text;
+
+    // write aside and rename, other threads and workers may want the same entry
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    std::ostringstream temporary;
+    temporary << dir << "/." << query.key << "." << getpid() << "."
+                << std::hash<std::thread::id>()(std::this_thread::get_id());
+    {
+        std::ofstream out(temporary.str());
+        out << entry.str();
+        if (!out) {
+            std::remove(temporary.str().c_str());
+            return;
+        }
+    }
+    std::rename(temporary.str().c_str(), (dir + "/" + query.key).c_str());
+}
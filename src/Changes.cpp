@@ -0,0 +1,151 @@
+#include "Changes.h"
+#include "Cache.h"
+
+#include "z3++.h"
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+
+// sources are read once per run, rules run on several threads
+static std::mutex sources_mutex;
+static std::map<std::string, std::string> sources;
+
+static bool read_source(const std::string &path, std::string &text) {
+    std::lock_guard<std::mutex> lock(sources_mutex);
+    auto found = sources.find(path);
+    if (found == sources.end()) {
+        std::ifstream in(path);
+        if (!in) {
+            return false;
+        }
+        std::ostringstream contents;
+        contents << in.rdbuf();
+        found = sources.emplace(path, contents.str()).first;
+    }
+    text = found->second;
+    return true;
+}
+
+// the definition of function, from its signature to the closing brace in
+// the first column
+static bool find_function(const std::string &text, const std::string &function, size_t &begin, size_t &end) {
+    std::string signature = "\nvoid " + function + "(";
+    begin = text.find(signature);
+    if (begin == std::string::npos) {
+        return false;
+    }
+    begin++;
+    end = text.find("\n}", begin);
+    end = (end == std::string::npos) ? text.size() : end + 2;
+    return true;
+}
+
+// headers included with quotes, and the src/ files that implement them
+static void add_dependencies(const fs::path &file, const fs::path &root, std::set<fs::path> &seen) {
+    std::string text;
+    if (!seen.insert(file).second || !read_source(file.string(), text)) {
+        return;
+    }
+
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.rfind("#include \"", 0) != 0) {
+            continue;
+        }
+        std::string header = line.substr(10, line.find('"', 10) - 10);
+        fs::path path = root / "include" / header;
+        if (!fs::exists(path)) {
+            continue;
+        }
+        add_dependencies(path, root, seen);
+        fs::path implementation = root / "src" / fs::path(header).replace_extension(".cpp");
+        if (fs::exists(implementation)) {
+            add_dependencies(implementation, root, seen);
+        }
+    }
+}
+
+std::string rule_fingerprint(const Rule &rule, const std::string &options) {
+    std::string text;
+    size_t begin, end;
+    if (rule.file.empty() || !read_source(rule.file, text) ||
+            !find_function(text, rule.function_name, begin, end)) {
+        return "";
+    }
+
+    std::string fingerprint = std::string(Z3_get_full_version()) + "\n" + options + "\n";
+    fingerprint += text.substr(begin, end - begin);
+
+    // the rest of the file, helpers and all, but not the other rules
+    std::string rest = text;
+    for (const Rule &other : all_rules()) {
+        if (other.file == rule.file && find_function(rest, other.function_name, begin, end)) {
+            rest.erase(begin, end - begin);
+        }
+    }
+    fingerprint += rest;
+
+    // rules live in checks/ or bugs/, one level below the root
+    fs::path file(rule.file);
+    std::set<fs::path> dependencies;
+    add_dependencies(file, file.parent_path().parent_path(), dependencies);
+    dependencies.erase(file);
+    for (const fs::path &dependency : dependencies) {
+        std::string source;
+        read_source(dependency.string(), source);
+        fingerprint += dependency.filename().string() + "\n" + source;
+    }
+    return hash_hex(fingerprint);
+}
+
+static std::string report_path(const std::string &dir, const Rule &rule) {
+    std::string name = rule.name;
+    for (char &c : name) {
+        c = (c == '/') ? '.' : c;
+    }
+    return dir + "/" + name;
+}
+
+bool load_rule_report(const std::string &dir, const Rule &rule, const std::string &fingerprint,
+                        std::string &report) {
+    std::ifstream in(report_path(dir, rule));
+    std::string recorded;
+    if (fingerprint.empty() || !std::getline(in, recorded) || recorded != fingerprint) {
+        return false;
+    }
+    std::ostringstream contents;
+    contents << in.rdbuf();
+    report = contents.str();
+    return true;
+}
+
+void store_rule_report(const std::string &dir, const Rule &rule, const std::string &fingerprint,
+                        const std::string &report) {
+    if (fingerprint.empty()) {
+        return;
+    }
+    std::error_code error;
+    fs::create_directories(dir, error);
+    std::string path = report_path(dir, rule);
+    std::ostringstream temporary;
+    temporary << path << "." << getpid() << "." << std::hash<std::thread::id>()(std::this_thread::get_id());
+    {
+        std::ofstream out(temporary.str());
+        out << fingerprint << "\n" << report;
+        if (!out) {
+            std::remove(temporary.str().c_str());
+            return;
+        }
+    }
+    std::rename(temporary.str().c_str(), path.c_str());
+}
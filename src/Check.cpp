@@ -1,117 +1,241 @@
 #include "Check.h"
+#include "Cache.h"
+#include "ContextPool.h"
+#include "Dedup.h"
+#include "Dual.h"
+#include "Logic.h"
+#include "Portfolio.h"
+
+#include <chrono>
+#include <memory>
+#include <sstream>
+
+static thread_local Family *current_family = nullptr;
+
+SolveOptions &solve_options() {
+    static SolveOptions options;
+    return options;
+}
 
-void check(z3::context &context, Operation op, Interval *a, 
-            Interval *b, Bound &e0, Bound &e1) {
+static void check_with(z3::solver &solver, const z3::expr_vector &assumptions, CheckResult &result) {
+    try {
+        result.status = assumptions.empty() ? solver.check() : solver.check(assumptions);
+        if (result.status == z3::unknown) {
+            result.reason_unknown = solver.reason_unknown();
+        } else if (result.status == z3::sat) {
+            result.model = solver.get_model();
+        }
+    } catch (const z3::exception &e) {
+        result.status = z3::unknown;
+        result.reason_unknown = e.msg();
+    }
+}
 
-    z3::expr i = context.int_const("i");
-    z3::expr j = context.int_const("j");
-    z3::solver solver(context);
+static void solve_uncached(z3::solver &solver, const z3::expr_vector &assumptions, CheckResult &result) {
+    bool dual = solve_options().dual && classify_query(solver.assertions(), assumptions) == Logic::QF_BV;
+    if (dual && solve_integer_first(solver, assumptions, result)) {
+        return;
+    }
 
-    apply_interval(solver, a, i);
-    apply_interval(solver, b, j);
+    Strategy strategy;
+    if (solve_options().classify) {
+        Logic logic = classify_query(solver.assertions(), assumptions);
+        strategy = logic_strategy(logic);
+        result.logic = LogicToString(logic);
+    }
 
-    z3::expr res = generate_op(op, i, j);
+    if (solve_options().portfolio) {
+        std::string logic = result.logic;
+        result = solve_portfolio(solver, assumptions);
+        result.logic = logic;
+    } else if (!strategy.tactic.empty()) {
+        // a fresh solver for this query alone, assumptions become assertions
+        z3::solver tuned = make_tactic(solver.ctx(), strategy.tactic).mk_solver();
+        tuned.add(solver.assertions());
+        tuned.add(assumptions);
+        result.solved_by = strategy.name;
+        check_with(tuned, z3::expr_vector(solver.ctx()), result);
+    } else {
+        check_with(solver, assumptions, result);
+    }
+    if (dual) {
+        result.solved_by = result.solved_by.empty() ? "bv" : "bv " + result.solved_by;
+    }
+}
 
-    if (e0.type != Unbounded && e1.type != Unbounded) {
-        solver.add((res < e0.expr) || (res > e1.expr));
-    } else if (e0.type != Unbounded) {
-        solver.add(res < e0.expr);
-    } else if (e1.type != Unbounded) {
-        solver.add(res > e1.expr);
+CheckResult solve(z3::solver &solver, const Describe &describe) {
+    return solve(solver, z3::expr_vector(solver.ctx()), describe);
+}
+
+CheckResult solve(z3::solver &solver, const z3::expr_vector &assumptions,
+                    const Describe &describe) {
+    const SolveOptions &options = solve_options();
+    CheckResult result;
+    auto start = std::chrono::steady_clock::now();
+
+    std::unique_ptr<CanonicalQuery> canonical;
+    std::unique_ptr<SharedQuery> shared;
+    if (!options.cache_dir.empty() || options.dedup) {
+        std::ostringstream parameters;
+        parameters << "classify=" << options.classify << " portfolio=" << options.portfolio;
+        canonical.reset(new CanonicalQuery(canonicalize(solver.assertions(), assumptions, parameters.str())));
+    }
+    if (options.dedup) {
+        shared.reset(new SharedQuery(*canonical));
+        result.shared = shared->Answered(solver.ctx(), result);
     }
 
-    if(solver.check() == z3::unsat) {
-        std::cout << "proved" << std::endl;
-        std::cout << "Operation: ";
-        std::cout << a->ToStringSymbolic();
-        std::cout << " " << OpToString(op) << " ";
-        std::cout << b->ToStringSymbolic() << std::endl;
-        std::cout << " = [ " << e0.ToStringSymbolic() << ", " << e1.ToStringSymbolic() << " ]" << std::endl;
-    } else if (solver.check() == z3::unknown) {
-        std::cout << "ERROR: z3 unable to prove or disprove" << std::endl;
-        std::cout << "Operation: ";
-        std::cout << a->ToStringSymbolic();
-        std::cout << " " << OpToString(op) << " ";
-        std::cout << b->ToStringSymbolic() << std::endl;
-        std::cout << " = [ " << e0.ToStringSymbolic() << ", " << e1.ToStringSymbolic() << " ]" << std::endl;
-    } else { // sat
-        std::cout << "failed to prove" << std::endl;
-        z3::model model = solver.get_model();
-
-        std::cout << "Operation: ";
-        std::cout << a->ToString(model);
-        std::cout << " " << OpToString(op) << " ";
-        std::cout << b->ToString(model) << std::endl;
-        std::cout << " = [ " << e0.ToStringSymbolic(true) << ", " << e1.ToStringSymbolic(true) << " ]" << std::endl;
-
-        std::cout << "Resultant bounds: [";
-        if (e0.expr) {
-            std::cout << model.eval(e0.expr);
+    if (!result.shared) {
+        CheckResult cached;
+        bool in_cache = !options.cache_dir.empty() && cache_load(options.cache_dir, *canonical, solver.ctx(), cached);
+        if (in_cache && !options.recheck) {
+            result = cached;
+            result.cached = true;
         } else {
-            std::cout << "_";
+            solve_uncached(solver, assumptions, result);
+            if (!options.cache_dir.empty()) {
+                result.stale_cache = in_cache && result.status != z3::unknown && result.status != cached.status;
+                if (!in_cache || result.stale_cache) {
+                    cache_store(options.cache_dir, *canonical, result);
+                }
+            }
         }
-        std::cout << ", ";
-        if (e1.expr) {
-            std::cout << model.eval(e1.expr);
-        } else {
-            std::cout << "_";
-        }
-        std::cout << "]" << std::endl;
+    }
+    // a shared verdict cost this rule only the wait for it
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (shared && !result.shared) {
+        shared->Publish(result);
+    }
 
-        std::cout << "Contradiction: ";
-        std::cout << model.eval(i);
-        std::cout << " " << OpToString(op) << " ";
-        std::cout << model.eval(j);
-        std::cout << " = " << model.eval(res) << std::endl;
+    if (result.status == z3::sat && describe) {
+        result.counterexample = Counterexample(*result.model, describe);
     }
+    return result;
 }
 
-z3::check_result check_bound(z3::context &context, Operation op, Interval *a, 
-            Interval *b, Bound &bound) {
-
-    z3::expr i = context.int_const("i");
-    z3::expr j = context.int_const("j");
-    z3::solver solver(context);
+const std::string &Counterexample::Text() const {
+    if (model) {
+        std::ostringstream out;
+        describe(out, *model);
+        text = out.str();
+        model.reset();
+        describe = nullptr;
+    }
+    return text;
+}
 
-    apply_interval(solver, a, i);
-    apply_interval(solver, b, j);
+void Counterexample::Clear() {
+    model.reset();
+    describe = nullptr;
+    text.clear();
+}
 
-    z3::expr res = generate_op(op, i, j);
+Family::Family(z3::context &context)
+    : context(context), solver(context), previous(current_family) {
+    current_family = this;
+}
 
-    solver.add(res == bound.expr);
+Family::~Family() {
+    current_family = previous;
+}
 
-    z3::check_result ans = solver.check();
-    return ans;
+z3::expr Family::NewCase() {
+    std::string name = "case" + std::to_string(cases++);
+    return context.bool_const(name.c_str());
 }
 
-void print_tightness(z3::context &context, Operation op, Interval *a, 
-            Interval *b, Bound &bound) {
+Family *Family::Current() {
+    return current_family;
+}
 
-    z3::check_result res = check_bound(context, op, a, b, bound);
-    if (res == z3::unsat) {
-        std::cout << " NOT tight." << std::endl;
-    } else if (res == z3::unknown) {
-        std::cout << " Unknown." << std::endl;
-    } else {
-        std::cout << " Tight." << std::endl;
+Session::Session(z3::context &context, Operation op, const Interval &a, const Interval &b)
+    : op(op), a(a), b(b), solver(context),
+      i(int_symbol(context, "i")), j(int_symbol(context, "j")), res(generate_op(op, i, j)),
+      assumptions(context) {
+    Family *family = Family::Current();
+    if (family == nullptr || &family->context != &context) {
+        apply_interval(solver, a, i);
+        apply_interval(solver, b, j);
+        return;
     }
+
+    // the intervals only hold for this case
+    z3::solver intervals(context);
+    apply_interval(intervals, a, i);
+    apply_interval(intervals, b, j);
+    z3::expr selected = family->NewCase();
+    solver = family->solver;
+    solver.add(z3::implies(selected, z3::mk_and(intervals.assertions())));
+    assumptions.push_back(selected);
 }
 
+CheckResult Session::Check(Bound &e0, Bound &e1) {
+    solver.push();
+    if (e0.type != Unbounded && e1.type != Unbounded) {
+        solver.add((res < e0.expr) || (res > e1.expr));
+    } else if (e0.type != Unbounded) {
+        solver.add(res < e0.expr);
+    } else if (e1.type != Unbounded) {
+        solver.add(res > e1.expr);
+    }
+
+    // by value, the counterexample may be rendered after this session is gone
+    CheckResult result = solve(solver, assumptions, [a = a, b = b, op = op, i = i, j = j, res = res, e0, e1](
+                                                        std::ostream &out, z3::model &model) {
+        out << "Operation: ";
+        out << a.ToString(model);
+        out << " " << OpToString(op) << " ";
+        out << b.ToString(model) << std::endl;
+        out << " = [ " << e0.ToStringSymbolic(true) << ", " << e1.ToStringSymbolic(true) << " ]" << std::endl;
 
+        out << "Resultant bounds: [";
+        if (e0.expr) {
+            out << model.eval(e0.expr);
+        } else {
+            out << "_";
+        }
+        out << ", ";
+        if (e1.expr) {
+            out << model.eval(e1.expr);
+        } else {
+            out << "_";
+        }
+        out << "]" << std::endl;
+
+        out << "Contradiction: ";
+        out << model.eval(i);
+        out << " " << OpToString(op) << " ";
+        out << model.eval(j);
+        out << " = " << model.eval(res) << std::endl;
+    });
+    solver.pop();
+
+    if (result.status != z3::sat) {
+        std::ostringstream statement;
+        statement << "Operation: ";
+        statement << a.ToStringSymbolic();
+        statement << " " << OpToString(op) << " ";
+        statement << b.ToStringSymbolic() << std::endl;
+        statement << " = [ " << e0.ToStringSymbolic() << ", " << e1.ToStringSymbolic() << " ]" << std::endl;
+        result.statement = statement.str();
+    }
+    return result;
+}
 
-void check_tightness(z3::context &context, Operation op, Interval *a, 
-            Interval *b, Bound &e0, Bound &e1)  {
-    
+TightnessResult Session::CheckTightness(Bound &e0, Bound &e1) {
+    TightnessResult result;
+    // query for whether the bound is attained by some op(i, j)
     if (e0.type != Unbounded) {
-        std::cout << "Checking lower bound tightness...";
-        print_tightness(context, op, a, b, e0);
+        solver.push();
+        solver.add(res == e0.expr);
+        result.lower = solve(solver, assumptions);
+        solver.pop();
     }
-
     if (e1.type != Unbounded) {
-        std::cout << "Checking upper bound tightness...";
-        print_tightness(context, op, a, b, e1);
+        solver.push();
+        solver.add(res == e1.expr);
+        result.upper = solve(solver, assumptions);
+        solver.pop();
     }
-
-    delete a;
-    delete b;
+    return result;
 }
@@ -0,0 +1,59 @@
+#include "ContextPool.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <utility>
+
+namespace {
+
+std::atomic<unsigned> current_generation{0};
+
+struct Pool {
+    std::unique_ptr<z3::context> context;
+    unsigned generation = 0;
+    // (name, bits) -> constant, 0 bits for an integer; declared after the
+    // context so they go before it does
+    std::map<std::pair<std::string, unsigned>, z3::expr> symbols;
+
+    void Reset() {
+        symbols.clear();
+        context.reset(new z3::context());
+        generation = current_generation;
+    }
+};
+
+thread_local Pool pool;
+
+z3::expr symbol(z3::context &context, const std::string &name, unsigned bits) {
+    if (&context != pool.context.get()) {
+        return bits == 0 ? context.int_const(name.c_str()) : context.bv_const(name.c_str(), bits);
+    }
+    auto found = pool.symbols.find({name, bits});
+    if (found == pool.symbols.end()) {
+        z3::expr constant = bits == 0 ? context.int_const(name.c_str()) : context.bv_const(name.c_str(), bits);
+        found = pool.symbols.emplace(std::make_pair(name, bits), constant).first;
+    }
+    return found->second;
+}
+
+} // namespace
+
+z3::context &rule_context() {
+    if (!pool.context || pool.generation != current_generation) {
+        pool.Reset();
+    }
+    return *pool.context;
+}
+
+void reset_rule_contexts() {
+    current_generation++;
+}
+
+z3::expr int_symbol(z3::context &context, const std::string &name) {
+    return symbol(context, name, 0);
+}
+
+z3::expr bv_symbol(z3::context &context, const std::string &name, unsigned bits) {
+    return symbol(context, name, bits);
+}
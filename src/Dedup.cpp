@@ -0,0 +1,93 @@
+#include "Dedup.h"
+
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+struct SharedQuery::Entry {
+    std::mutex mutex;
+    std::condition_variable done_changed;
+    bool done = false;
+    // false if the owner gave up or its answer does not carry over
+    bool usable = false;
+    CheckResult result;                 // without the model
+    std::vector<ConstantValue> model;
+};
+
+namespace {
+
+std::mutex table_mutex;
+// by canonical text, sorts included, the hash alone could collide
+std::unordered_map<std::string, std::shared_ptr<SharedQuery::Entry>> table;
+DedupTally tally;
+
+} // namespace
+
+SharedQuery::SharedQuery(const CanonicalQuery &query) : query(query) {
+    std::lock_guard<std::mutex> lock(table_mutex);
+    tally.queries++;
+    std::shared_ptr<Entry> &found = table[query.text];
+    if (!found) {
+        found = std::make_shared<Entry>();
+        owner = true;
+    }
+    entry = found;
+}
+
+SharedQuery::~SharedQuery() {
+    if (owner) {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+        if (!entry->done) {
+            entry->done = true;
+            entry->done_changed.notify_all();
+        }
+    }
+}
+
+bool SharedQuery::Answered(z3::context &context, CheckResult &result) {
+    if (owner) {
+        return false;
+    }
+    std::unique_lock<std::mutex> lock(entry->mutex);
+    entry->done_changed.wait(lock, [this] { return entry->done; });
+    if (!entry->usable) {
+        return false;
+    }
+    result = entry->result;
+    if (result.status == z3::sat) {
+        result.model = model_from_values(query, context, entry->model);
+    }
+    std::lock_guard<std::mutex> table_lock(table_mutex);
+    tally.shared++;
+    tally.solver_seconds += entry->result.seconds;
+    return true;
+}
+
+void SharedQuery::Publish(const CheckResult &result) {
+    if (!owner) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(entry->mutex);
+    entry->result = result;
+    entry->result.model.reset();
+    entry->result.counterexample.Clear();
+    entry->result.stale_cache = false;
+    entry->usable = result.status != z3::sat || model_values(query, *result.model, entry->model);
+    entry->done = true;
+    entry->done_changed.notify_all();
+}
+
+DedupTally dedup_tally() {
+    std::lock_guard<std::mutex> lock(table_mutex);
+    return tally;
+}
+
+void print_dedup_summary(std::ostream &out) {
+    DedupTally summary = dedup_tally();
+    out << summary.shared << " of " << summary.queries << " queries were identical to one solved before in "
+        << "this run and took its verdict, saving " << std::fixed << std::setprecision(3)
+        << summary.solver_seconds << "s." << std::endl;
+}
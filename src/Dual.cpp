@@ -0,0 +1,391 @@
+#include "Dual.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <unordered_map>
+
+// 2^n in decimal, n may be well past 64 (sign extensions to 128 bits)
+static std::string power_of_two(unsigned n) {
+    std::string digits = "1";   // least significant first
+    for (unsigned i = 0; i < n; i++) {
+        int carry = 0;
+        for (char &digit : digits) {
+            int doubled = (digit - '0') * 2 + carry;
+            digit = '0' + doubled % 10;
+            carry = doubled / 10;
+        }
+        if (carry) {
+            digits.push_back('0' + carry);
+        }
+    }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+}
+
+namespace {
+
+// translates one query, term by term, sharing the translation of shared terms
+class Translator {
+    // before facts, which is built in it
+    z3::context &context;
+
+public:
+    explicit Translator(z3::context &context) : context(context), facts(context) {}
+
+    // the integer counterpart of e; check failed afterwards
+    z3::expr Translate(const z3::expr &e) {
+        auto found = memo.find(e.id());
+        if (found != memo.end()) {
+            return found->second;
+        }
+        z3::expr translated = Convert(e);
+        memo.emplace(e.id(), translated);
+        return translated;
+    }
+
+    bool failed = false;
+    // the ranges of the translated terms that need them
+    z3::expr_vector facts;
+
+private:
+    z3::expr Power(unsigned n) {
+        auto found = powers.find(n);
+        if (found == powers.end()) {
+            found = powers.emplace(n, context.int_val(power_of_two(n).c_str())).first;
+        }
+        return found->second;
+    }
+
+    z3::expr Wrap(const z3::expr &x, unsigned width) {
+        return z3::mod(x, Power(width));
+    }
+
+    // the two's complement reading of an unsigned value
+    z3::expr Signed(const z3::expr &x, unsigned width) {
+        return z3::ite(x >= Power(width - 1), x - Power(width), x);
+    }
+
+    // a value in [0, 2^width)
+    z3::expr Fresh(unsigned width) {
+        std::string name = "bits!" + std::to_string(fresh++);
+        z3::expr x = context.int_const(name.c_str());
+        facts.push_back(x >= 0 && x < Power(width));
+        return x;
+    }
+
+    // what a | b, a & b and a ^ b are known to lie within
+    z3::expr Bitwise(Z3_decl_kind kind, const z3::expr &a, const z3::expr &b, unsigned width) {
+        z3::expr r = Fresh(width);
+        if (kind == Z3_OP_BOR) {
+            facts.push_back(r >= a && r >= b && r <= a + b);
+        } else if (kind == Z3_OP_BAND) {
+            facts.push_back(r <= a && r <= b && r >= a + b - (Power(width) - 1));
+        } else {
+            facts.push_back(r <= a + b && r >= a - b && r >= b - a);
+        }
+        return r;
+    }
+
+    // a shifted by a constant amount
+    z3::expr ShiftBy(Z3_decl_kind kind, const z3::expr &a, uint64_t amount, unsigned width) {
+        if (amount >= width) {
+            if (kind == Z3_OP_BASHR) {
+                return z3::ite(a >= Power(width - 1), Power(width) - 1, context.int_val(0));
+            }
+            return context.int_val(0);
+        } else if (kind == Z3_OP_BSHL) {
+            return Wrap(a * Power(amount), width);
+        } else if (kind == Z3_OP_BLSHR) {
+            return a / Power(amount);
+        }
+        // div rounds down for positive divisors, as an arithmetic shift does
+        return Wrap(Signed(a, width) / Power(amount), width);
+    }
+
+    // a shifted by b, one case per amount below the width
+    z3::expr Shift(Z3_decl_kind kind, const z3::expr &a, const z3::expr &b, unsigned width) {
+        uint64_t amount;
+        if (b.is_numeral_u64(amount)) {
+            return ShiftBy(kind, a, amount, width);
+        }
+        z3::expr shifted = ShiftBy(kind, a, width, width);
+        for (unsigned k = width; k-- > 0;) {
+            shifted = z3::ite(b == (int)k, ShiftBy(kind, a, k, width), shifted);
+        }
+        return shifted;
+    }
+
+    z3::expr Convert(const z3::expr &e) {
+        if (!e.is_app()) {
+            failed = true;
+            return e;
+        }
+        z3::sort sort = e.get_sort();
+        if (!sort.is_bool() && !sort.is_bv()) {
+            failed = true;
+            return e;
+        }
+        unsigned width = sort.is_bv() ? sort.bv_size() : 0;
+
+        z3::expr_vector args(context);
+        for (unsigned a = 0; a < e.num_args(); a++) {
+            args.push_back(Translate(e.arg(a)));
+        }
+        if (failed) {
+            // the query is lost anyway, and args may mix sorts
+            return e;
+        }
+        // operand widths, for comparisons and extensions
+        unsigned operand_width = e.num_args() > 0 && e.arg(0).is_bv() ? e.arg(0).get_sort().bv_size() : 0;
+
+        Z3_decl_kind kind = e.decl().decl_kind();
+        switch (kind) {
+            case Z3_OP_TRUE:
+            case Z3_OP_FALSE: {
+                return e;
+            }
+            case Z3_OP_AND: {
+                return z3::mk_and(args);
+            }
+            case Z3_OP_OR: {
+                return z3::mk_or(args);
+            }
+            case Z3_OP_NOT: {
+                return !args[0];
+            }
+            case Z3_OP_IMPLIES: {
+                return z3::implies(args[0], args[1]);
+            }
+            case Z3_OP_IFF:
+            case Z3_OP_EQ: {
+                return args[0] == args[1];
+            }
+            case Z3_OP_XOR: {
+                return args[0] != args[1];
+            }
+            case Z3_OP_DISTINCT: {
+                return z3::distinct(args);
+            }
+            case Z3_OP_ITE: {
+                return z3::ite(args[0], args[1], args[2]);
+            }
+            case Z3_OP_ULEQ: {
+                return args[0] <= args[1];
+            }
+            case Z3_OP_ULT: {
+                return args[0] < args[1];
+            }
+            case Z3_OP_UGEQ: {
+                return args[0] >= args[1];
+            }
+            case Z3_OP_UGT: {
+                return args[0] > args[1];
+            }
+            case Z3_OP_SLEQ: {
+                return Signed(args[0], operand_width) <= Signed(args[1], operand_width);
+            }
+            case Z3_OP_SLT: {
+                return Signed(args[0], operand_width) < Signed(args[1], operand_width);
+            }
+            case Z3_OP_SGEQ: {
+                return Signed(args[0], operand_width) >= Signed(args[1], operand_width);
+            }
+            case Z3_OP_SGT: {
+                return Signed(args[0], operand_width) > Signed(args[1], operand_width);
+            }
+            case Z3_OP_BNUM: {
+                return context.int_val(e.get_decimal_string(0).c_str());
+            }
+            case Z3_OP_BADD: {
+                z3::expr sum = args[0];
+                for (unsigned a = 1; a < args.size(); a++) {
+                    sum = sum + args[a];
+                }
+                return Wrap(sum, width);
+            }
+            case Z3_OP_BSUB: {
+                return Wrap(args[0] - args[1], width);
+            }
+            case Z3_OP_BNEG: {
+                return Wrap(-args[0], width);
+            }
+            case Z3_OP_BMUL: {
+                z3::expr product = args[0];
+                for (unsigned a = 1; a < args.size(); a++) {
+                    product = product * args[a];
+                }
+                return Wrap(product, width);
+            }
+            case Z3_OP_BNOT: {
+                return Power(width) - 1 - args[0];
+            }
+            case Z3_OP_BAND:
+            case Z3_OP_BOR:
+            case Z3_OP_BXOR: {
+                z3::expr combined = args[0];
+                for (unsigned a = 1; a < args.size(); a++) {
+                    combined = Bitwise(kind, combined, args[a], width);
+                }
+                return combined;
+            }
+            case Z3_OP_BSHL:
+            case Z3_OP_BLSHR:
+            case Z3_OP_BASHR: {
+                return Shift(kind, args[0], args[1], width);
+            }
+            case Z3_OP_EXTRACT: {
+                unsigned low = Z3_get_decl_int_parameter(context, e.decl(), 1);
+                return Wrap(args[0] / Power(low), width);
+            }
+            case Z3_OP_CONCAT: {
+                z3::expr value = args[0];
+                for (unsigned a = 1; a < args.size(); a++) {
+                    value = value * Power(e.arg(a).get_sort().bv_size()) + args[a];
+                }
+                return value;
+            }
+            case Z3_OP_ZERO_EXT: {
+                return args[0];
+            }
+            case Z3_OP_SIGN_EXT: {
+                return z3::ite(args[0] >= Power(operand_width - 1),
+                                args[0] + (Power(width) - Power(operand_width)), args[0]);
+            }
+            case Z3_OP_UNINTERPRETED: {
+                if (e.num_args() > 0) {
+                    break;
+                } else if (sort.is_bool()) {
+                    return e;
+                }
+                z3::expr x = context.int_const(e.decl().name().str().c_str());
+                facts.push_back(x >= 0 && x < Power(width));
+                return x;
+            }
+            default: {
+                break;
+            }
+        }
+        // division, remainders, overflow predicates, rotations, ...
+        failed = true;
+        return e;
+    }
+
+    std::unordered_map<unsigned, z3::expr> memo;
+    std::map<unsigned, z3::expr> powers;
+    unsigned fresh = 0;
+};
+
+std::mutex tally_mutex;
+DualTally tally;
+
+} // namespace
+
+std::optional<z3::expr_vector> integer_abstraction(const z3::expr_vector &assertions,
+                                                    const z3::expr_vector &assumptions) {
+    Translator translator(assertions.ctx());
+    z3::expr_vector translated(assertions.ctx());
+    for (unsigned a = 0; a < assertions.size(); a++) {
+        translated.push_back(translator.Translate(assertions[a]));
+    }
+    for (unsigned a = 0; a < assumptions.size(); a++) {
+        translated.push_back(translator.Translate(assumptions[a]));
+    }
+    if (translator.failed) {
+        return std::nullopt;
+    }
+    for (unsigned f = 0; f < translator.facts.size(); f++) {
+        translated.push_back(translator.facts[f]);
+    }
+    return translated;
+}
+
+bool solve_integer_first(z3::solver &solver, const z3::expr_vector &assumptions, CheckResult &result) {
+    const SolveOptions &options = solve_options();
+    auto start = std::chrono::steady_clock::now();
+    std::optional<z3::expr_vector> translated = integer_abstraction(solver.assertions(), assumptions);
+    if (!translated) {
+        std::lock_guard<std::mutex> lock(tally_mutex);
+        tally.queries++;
+        tally.untranslated++;
+        return false;
+    }
+
+    z3::context &context = solver.ctx();
+    z3::solver integers(context);
+    z3::params params(context);
+    params.set("timeout", options.dual_budget_ms);
+    integers.set(params);
+    integers.add(*translated);
+    z3::check_result status = z3::unknown;
+    try {
+        status = integers.check();
+    } catch (const z3::exception &) {
+        // e.g. canceled, the bit-vector query still gets its chance
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (status != z3::unsat) {
+        std::lock_guard<std::mutex> lock(tally_mutex);
+        tally.queries++;
+        tally.wasted_seconds += seconds;
+        return false;
+    }
+    result.status = z3::unsat;
+    result.solved_by = "int";
+
+    double bitvector_seconds = 0;
+    if (options.dual_savings) {
+        // outside the verdict, only to learn what the integers saved
+        auto bitvector_start = std::chrono::steady_clock::now();
+        z3::check_result bitvector_status = z3::unknown;
+        try {
+            bitvector_status = assumptions.empty() ? solver.check() : solver.check(assumptions);
+        } catch (const z3::exception &) {
+        }
+        bitvector_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - bitvector_start).count();
+        if (bitvector_status == z3::sat) {
+            std::cerr << "WARNING: the integer abstraction proved a satisfiable bit-vector query" << std::endl;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(tally_mutex);
+    tally.queries++;
+    tally.by_integers++;
+    tally.integer_seconds += seconds;
+    if (options.dual_savings) {
+        tally.measured++;
+        tally.bitvector_seconds += bitvector_seconds;
+    }
+    return true;
+}
+
+DualTally dual_tally() {
+    std::lock_guard<std::mutex> lock(tally_mutex);
+    return tally;
+}
+
+void print_dual_summary(std::ostream &out) {
+    DualTally summary = dual_tally();
+    unsigned fell_back = summary.queries - summary.by_integers - summary.untranslated;
+    out << std::fixed << std::setprecision(3);
+    out << "Integers proved " << summary.by_integers << " of " << summary.queries << " bit-vector queries in "
+        << summary.integer_seconds << "s; " << fell_back << " fell back to bit-vectors after "
+        << summary.wasted_seconds << "s, " << summary.untranslated << " could not be translated." << std::endl;
+    if (summary.measured > 0) {
+        double saved = summary.bitvector_seconds - summary.integer_seconds;
+        double net = saved - summary.wasted_seconds;
+        auto change = [](double seconds) {
+            std::ostringstream text;
+            text << std::fixed << std::setprecision(3) << std::abs(seconds) << (seconds >= 0 ? "s saved" : "s lost");
+            return text.str();
+        };
+        out << "Bit-vectors took " << summary.bitvector_seconds << "s on those " << summary.measured
+            << " queries: " << change(saved) << ", " << change(net) << " counting the attempts that fell back."
+            << std::endl;
+    }
+}
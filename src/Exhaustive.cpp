@@ -0,0 +1,330 @@
+#include "Exhaustive.h"
+#include "Runner.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+int left_shift8(int a, int b, bool aIsUint, bool bIsUint) {
+    int bits;
+    if (!bIsUint && value8(b, true) < 0) {
+        // ui_shift_left and int_shift_left shift the other way
+        bits = aIsUint ? lshr8(a, -b) : ashr8(a, -b);
+    } else {
+        // a * (1 << b) in int_shift_left is the same bits as a << b
+        bits = shl8(a, b);
+    }
+    return value8(bits, !aIsUint);
+}
+
+int right_shift8(int a, int b, bool aIsUint, bool bIsUint) {
+    int bits;
+    if (!bIsUint && value8(b, true) < 0) {
+        bits = shl8(a, -b);
+    } else {
+        bits = aIsUint ? lshr8(a, b) : ashr8(a, b);
+    }
+    return value8(bits, !aIsUint);
+}
+
+static int set_bits8(int value) {
+    return __builtin_popcount(bits8(value));
+}
+
+bool left_shift_overflows8(int i, int j, int res, bool iIsUint, bool jIsUint) {
+    bool jpos = jIsUint || value8(j, true) >= 0;
+    bool pos_bit_count = set_bits8(i) != set_bits8(res) && (iIsUint || value8(i, true) >= 0);
+    bool neg_overflow = false;
+    if (!iIsUint) {
+        // i << j on i and j sign extended to 16 bits, against INT_MIN for 8 bits
+        int extend_i = value8(i, true) & 0xffff, extend_j = value8(j, true) & 0xffff;
+        int shifted;
+        if (!jIsUint && (extend_j & 0x8000)) {
+            int amount = -(int16_t)extend_j;
+            shifted = (amount >= 16) ? ((extend_i & 0x8000) ? 0xffff : 0) : ((int16_t)extend_i >> amount) & 0xffff;
+        } else {
+            shifted = (extend_j >= 16) ? 0 : (extend_i << extend_j) & 0xffff;
+        }
+        neg_overflow = (int16_t)shifted < -128;
+    }
+    bool sign_change = !iIsUint && value8(i, true) > 0 && value8(res, true) < 0;
+    return jpos && (pos_bit_count || sign_change || neg_overflow);
+}
+
+bool right_shift_overflows8(int i, int j, int res, bool aIsUint) {
+    bool bad_bit_count = set_bits8(i) != set_bits8(res);
+    bool sign_change = value8(i, true) > 0 && value8(res, true) < 0;
+    return !aIsUint && value8(j, true) < 0 && (bad_bit_count || sign_change);
+}
+
+namespace {
+
+// Results are kept as int16 values, with these standing for "no pair" in
+// running minima and maxima, so that an empty box never violates anything.
+const int16_t no_min = 32767;
+const int16_t no_max = -32768;
+
+int value_at(int index, bool is_signed) {
+    return is_signed ? index - 128 : index;
+}
+
+// mn = min(mn, row_min), mx = max(mx, row_max), over 256 lanes
+void accumulate(int16_t *mn, int16_t *mx, const int16_t *row_min, const int16_t *row_max) {
+    for (int k = 0; k < 256; k++) {
+        mn[k] = std::min(mn[k], row_min[k]);
+        mx[k] = std::max(mx[k], row_max[k]);
+    }
+}
+
+// rmin[k] = min(rmin[k], least), rmax[k] = max(rmax[k], greatest) for k >= from
+void spread(int16_t *rmin, int16_t *rmax, int from, int16_t least, int16_t greatest) {
+    for (int k = from; k < 256; k++) {
+        rmin[k] = std::min(rmin[k], least);
+        rmax[k] = std::max(rmax[k], greatest);
+    }
+}
+
+// the first k in [from, to] where the box breaks its bounds, and where an
+// applicable box does not attain a checked end, -1 if none
+void scan(const int16_t *rmin, const int16_t *rmax, const int16_t *lo, const int16_t *hi, const int16_t *applies,
+            int from, int to, bool check_lower, bool check_upper, int &violation, int &loose) {
+    violation = loose = -1;
+    for (int k = from; k <= to; k++) {
+        if (violation < 0 && (rmin[k] < lo[k] || rmax[k] > hi[k])) {
+            violation = k;
+        }
+        if (loose < 0 && applies[k] && ((check_lower && rmin[k] > lo[k]) || (check_upper && rmax[k] < hi[k]))) {
+            loose = k;
+        }
+    }
+}
+
+class Search {
+public:
+    explicit Search(const ExhaustiveRule &rule) : rule(rule), table_min(256 * 256), table_max(256 * 256) {
+        check_lower = rule.result_ends & LowerEnd;
+        check_upper = rule.result_ends & UpperEnd;
+        for (int ia = 0; ia < 256; ia++) {
+            for (int jb = 0; jb < 256; jb++) {
+                int res;
+                bool defined = rule.op(value_at(ia, rule.a_signed), value_at(jb, rule.b_signed), res);
+                table_min[ia * 256 + jb] = defined ? res : no_min;
+                table_max[ia * 256 + jb] = defined ? res : no_max;
+            }
+        }
+    }
+
+    ExhaustiveResult Run() {
+        bool a_lower = rule.a_ends & LowerEnd, a_upper = rule.a_ends & UpperEnd;
+        if (!a_upper) {
+            // a is [a0, _], so each a0 only adds its own row to the next
+            std::fill(mn, mn + 256, no_min);
+            std::fill(mx, mx + 256, no_max);
+            for (int ia0 = 255; ia0 >= 0; ia0--) {
+                accumulate(mn, mx, &table_min[ia0 * 256], &table_max[ia0 * 256]);
+                if ((a_lower || ia0 == 0) && !CheckB(ia0, 255)) {
+                    return result;
+                }
+            }
+            return result;
+        }
+        for (int ia0 = 0; ia0 < (a_lower ? 256 : 1); ia0++) {
+            std::fill(mn, mn + 256, no_min);
+            std::fill(mx, mx + 256, no_max);
+            for (int ia1 = ia0; ia1 < 256; ia1++) {
+                accumulate(mn, mx, &table_min[ia1 * 256], &table_max[ia1 * 256]);
+                if (!CheckB(ia0, ia1)) {
+                    return result;
+                }
+            }
+        }
+        return result;
+    }
+
+private:
+    // every interval of b against a in [ia0, ia1], false at the first
+    // counterexample
+    bool CheckB(int ia0, int ia1) {
+        bool b_lower = rule.b_ends & LowerEnd, b_upper = rule.b_ends & UpperEnd;
+        int a0 = value_at(ia0, rule.a_signed), a1 = value_at(ia1, rule.a_signed);
+        std::fill(rmin, rmin + 256, no_min);
+        std::fill(rmax, rmax + 256, no_max);
+        for (int ib0 = 255; ib0 >= 0; ib0--) {
+            spread(rmin, rmax, ib0, mn[ib0], mx[ib0]);
+            if (!b_lower && ib0 != 0) {
+                continue;
+            }
+            int b0 = value_at(ib0, rule.b_signed);
+            int from = b_upper ? ib0 : 255;
+            for (int ib1 = from; ib1 < 256; ib1++) {
+                int lower, upper;
+                applies[ib1] = 0;
+                lo[ib1] = no_max;
+                hi[ib1] = no_min;
+                if (rmin[ib1] == no_min ||
+                    !rule.bound(a0, a1, b0, value_at(ib1, rule.b_signed), lower, upper)) {
+                    continue;
+                }
+                result.bounds++;
+                applies[ib1] = -1;
+                lo[ib1] = check_lower ? lower : no_max;
+                hi[ib1] = check_upper ? upper : no_min;
+            }
+
+            int violation, loose;
+            scan(rmin, rmax, lo, hi, applies, from, 255, check_lower, check_upper, violation, loose);
+            if (loose >= 0 && result.lower_tight && result.upper_tight) {
+                int b1 = value_at(loose, rule.b_signed);
+                result.loose_a0 = a0, result.loose_a1 = a1, result.loose_b0 = b0, result.loose_b1 = b1;
+                result.loose_lo = lo[loose], result.loose_hi = hi[loose];
+                result.least = rmin[loose], result.greatest = rmax[loose];
+            }
+            if (loose >= 0) {
+                // another box may miss the other end, so look at each end
+                for (int ib1 = from; ib1 < 256; ib1++) {
+                    if (applies[ib1]) {
+                        result.lower_tight &= !check_lower || rmin[ib1] <= lo[ib1];
+                        result.upper_tight &= !check_upper || rmax[ib1] >= hi[ib1];
+                    }
+                }
+            }
+            if (violation >= 0) {
+                Refute(a0, a1, ia0, ia1, b0, ib0, violation);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // records the box and a pair in it that lands outside its bounds
+    void Refute(int a0, int a1, int ia0, int ia1, int b0, int ib0, int ib1) {
+        result.sound = false;
+        result.a0 = a0, result.a1 = a1, result.b0 = b0, result.b1 = value_at(ib1, rule.b_signed);
+        result.lo = lo[ib1], result.hi = hi[ib1];
+        for (int ia = ia0; ia <= ia1; ia++) {
+            for (int jb = ib0; jb <= ib1; jb++) {
+                int i = value_at(ia, rule.a_signed), j = value_at(jb, rule.b_signed), res;
+                if (rule.op(i, j, res) && (res < result.lo || res > result.hi)) {
+                    result.i = i, result.j = j, result.res = res;
+                    return;
+                }
+            }
+        }
+    }
+
+    const ExhaustiveRule &rule;
+    bool check_lower, check_upper;
+    // i op j at [index of i * 256 + index of j], sentinels where undefined
+    std::vector<int16_t> table_min, table_max;
+    // least and greatest i op j over the current a, for each j
+    int16_t mn[256], mx[256];
+    // least and greatest result over the current a and b0, for each b1
+    int16_t rmin[256], rmax[256];
+    // the claimed bounds for each b1, sentinels where the rule does not apply
+    int16_t lo[256], hi[256], applies[256];
+    ExhaustiveResult result;
+};
+
+// e.g. "u[3, _]", with "_" for an unbounded end
+std::string interval_string(bool is_signed, BoundedEnds ends, int lower, int upper) {
+    std::ostringstream out;
+    out << (is_signed ? "" : "u") << "[";
+    out << ((ends & LowerEnd) ? std::to_string(lower) : "_") << ", ";
+    out << ((ends & UpperEnd) ? std::to_string(upper) : "_") << "]";
+    return out.str();
+}
+
+std::string describe(const std::string &name, const ExhaustiveRule &rule, const ExhaustiveResult &result) {
+    std::ostringstream out;
+    std::ostringstream notes;
+    notes << " [" << result.bounds << " bounds, " << std::fixed << std::setprecision(3) << result.seconds << "s]";
+    if (!result.sound) {
+        out << name << ": failed to prove" << notes.str() << std::endl;
+        out << interval_string(rule.a_signed, rule.a_ends, result.a0, result.a1) << " " << rule.op_name << " "
+            << interval_string(rule.b_signed, rule.b_ends, result.b0, result.b1) << std::endl;
+        out << "Resultant bounds: " << interval_string(rule.a_signed, rule.result_ends, result.lo, result.hi)
+            << std::endl;
+        out << "Contradiction: " << result.i << " " << rule.op_name << " " << result.j << " = " << result.res
+            << std::endl;
+        return out.str();
+    }
+    out << name << ": proved";
+    if (result.bounds == 0) {
+        // nothing to attain either
+        out << " vacuously, the rule applies to no operand bounds" << notes.str() << std::endl;
+        return out.str();
+    }
+    for (BoundedEnds end : {LowerEnd, UpperEnd}) {
+        if (rule.result_ends & end) {
+            bool tight = (end == LowerEnd) ? result.lower_tight : result.upper_tight;
+            out << ", " << (end == LowerEnd ? "lower" : "upper") << " bound " << (tight ? "tight" : "NOT tight");
+        }
+    }
+    out << notes.str() << std::endl;
+    if (!result.lower_tight || !result.upper_tight) {
+        out << "e.g. " << interval_string(rule.a_signed, rule.a_ends, result.loose_a0, result.loose_a1) << " "
+            << rule.op_name << " " << interval_string(rule.b_signed, rule.b_ends, result.loose_b0, result.loose_b1)
+            << " is within [" << result.least << ", " << result.greatest << "], not all of "
+            << interval_string(rule.a_signed, rule.result_ends, result.loose_lo, result.loose_hi) << std::endl;
+    }
+    return out.str();
+}
+
+} // namespace
+
+ExhaustiveResult check_exhaustive(const ExhaustiveRule &rule) {
+    auto start = std::chrono::steady_clock::now();
+    Search search(rule);
+    ExhaustiveResult result = search.Run();
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+std::map<std::string, ExhaustiveRule> &exhaustive_rules() {
+    // function-local for the same reason as all_rules()
+    static std::map<std::string, ExhaustiveRule> rules;
+    return rules;
+}
+
+ExhaustiveGroup::ExhaustiveGroup(const std::string &group,
+                                    std::initializer_list<std::pair<std::string, ExhaustiveRule>> entries) {
+    for (const auto &entry : entries) {
+        exhaustive_rules().emplace(group + "/" + entry.first, entry.second);
+    }
+}
+
+void run_exhaustive(const std::vector<const Rule *> &rules, unsigned jobs) {
+    struct Job {
+        std::string name;
+        const ExhaustiveRule *rule;
+        ExhaustiveResult result;
+    };
+    std::vector<Job> checked;
+    for (const Rule *rule : rules) {
+        auto twin = exhaustive_rules().find(rule->name);
+        if (twin != exhaustive_rules().end()) {
+            checked.push_back({rule->name, &twin->second});
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        // waits for every check when it goes out of scope
+        ThreadPool pool(std::max(jobs, 1u));
+        for (Job &job : checked) {
+            pool.Submit([&job] { job.result = check_exhaustive(*job.rule); });
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    unsigned failed = 0;
+    for (const Job &job : checked) {
+        std::cout << describe(job.name, *job.rule, job.result);
+        failed += !job.result.sound;
+    }
+    std::cout << (checked.size() - failed) << " proved, " << failed << " failed, "
+                << (rules.size() - checked.size()) << " rules without an exhaustive check ["
+                << std::fixed << std::setprecision(3) << seconds << "s]" << std::endl;
+}
@@ -0,0 +1,59 @@
+#include "HalideType.h"
+
+static TypeSemantics semantics = ScaledTypes;
+
+void set_type_semantics(TypeSemantics new_semantics) {
+    semantics = new_semantics;
+}
+
+TypeSemantics type_semantics() {
+    return semantics;
+}
+
+std::string TypeSemanticsToString(TypeSemantics semantics) {
+    return semantics == ExactTypes ? "exact" : "scaled";
+}
+
+std::string HalideType::Name() const {
+    return (is_signed ? "Int(" : "UInt(") + std::to_string(bits) + ")";
+}
+
+bool HalideType::OverflowIsUndefined() const {
+    return is_signed && (semantics == ScaledTypes || bits >= 32);
+}
+
+z3::expr HalideType::Variable(z3::context &context, const std::string &name) const {
+    return context.bv_const(name.c_str(), bits);
+}
+
+z3::expr HalideType::Value(z3::context &context, int64_t value) const {
+    return context.bv_val(value, bits);
+}
+
+z3::expr HalideType::LessEqual(const z3::expr &a, const z3::expr &b) const {
+    return is_signed ? (a <= b) : z3::ule(a, b);
+}
+
+z3::expr HalideType::Less(const z3::expr &a, const z3::expr &b) const {
+    return is_signed ? (a < b) : z3::ult(a, b);
+}
+
+z3::expr HalideType::Min(const z3::expr &a, const z3::expr &b) const {
+    return z3::ite(Less(a, b), a, b);
+}
+
+z3::expr HalideType::Max(const z3::expr &a, const z3::expr &b) const {
+    return z3::ite(Less(b, a), a, b);
+}
+
+HalideType type_of(const z3::expr &value, bool is_signed) {
+    return {is_signed, value.get_sort().bv_size()};
+}
+
+const std::vector<HalideType> &production_types() {
+    static const std::vector<HalideType> types = {
+        HalideType::Int(8), HalideType::Int(16), HalideType::Int(32), HalideType::Int(64),
+        HalideType::UInt(8), HalideType::UInt(16), HalideType::UInt(32), HalideType::UInt(64),
+    };
+    return types;
+}
@@ -0,0 +1,145 @@
+#include "Logic.h"
+
+#include <iostream>
+#include <unordered_set>
+
+std::string LogicToString(Logic logic) {
+    switch (logic) {
+        case Logic::Propositional: {
+            return "propositional";
+        }
+        case Logic::QF_LIA: {
+            return "QF_LIA";
+        }
+        case Logic::QF_NIA: {
+            return "QF_NIA";
+        }
+        case Logic::QF_BV: {
+            return "QF_BV";
+        }
+        case Logic::MixedLogic: {
+            return "mixed";
+        }
+        default: {
+            std::cerr << "Could not identify Logic in LogicToString()!" << std::endl;
+            return "LOGIC";
+        }
+    }
+}
+
+struct Features {
+    bool arithmetic = false;
+    bool nonlinear = false;
+    bool bitvector = false;
+    bool other = false;
+    std::unordered_set<unsigned> seen;
+};
+
+static void collect_features(const z3::expr &e, Features &features) {
+    if (!features.seen.insert(e.id()).second) {
+        return;
+    }
+
+    z3::sort sort = e.get_sort();
+    if (sort.is_int() || sort.is_real()) {
+        features.arithmetic = true;
+    } else if (sort.is_bv()) {
+        features.bitvector = true;
+    } else if (!sort.is_bool()) {
+        features.other = true;
+    }
+
+    if (!e.is_app()) {
+        // quantifiers and bound variables
+        features.other = true;
+        return;
+    }
+
+    unsigned args = e.num_args();
+    switch (e.decl().decl_kind()) {
+        case Z3_OP_MUL: {
+            unsigned variables = 0;
+            for (unsigned a = 0; a < args; a++) {
+                variables += !e.arg(a).is_numeral();
+            }
+            features.nonlinear |= variables > 1;
+            break;
+        }
+        case Z3_OP_DIV:
+        case Z3_OP_IDIV:
+        case Z3_OP_MOD:
+        case Z3_OP_REM: {
+            // division by a constant is still linear
+            features.nonlinear |= !e.arg(1).is_numeral();
+            break;
+        }
+        case Z3_OP_POWER: {
+            features.nonlinear = true;
+            break;
+        }
+        case Z3_OP_UNINTERPRETED: {
+            features.other |= args > 0;
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+
+    for (unsigned a = 0; a < args; a++) {
+        collect_features(e.arg(a), features);
+    }
+}
+
+Logic classify_query(const z3::expr_vector &assertions, const z3::expr_vector &assumptions) {
+    Features features;
+    for (unsigned a = 0; a < assertions.size(); a++) {
+        collect_features(assertions[a], features);
+    }
+    for (unsigned a = 0; a < assumptions.size(); a++) {
+        collect_features(assumptions[a], features);
+    }
+
+    if (features.other || (features.arithmetic && features.bitvector)) {
+        return Logic::MixedLogic;
+    } else if (features.bitvector) {
+        return Logic::QF_BV;
+    } else if (features.arithmetic) {
+        return features.nonlinear ? Logic::QF_NIA : Logic::QF_LIA;
+    }
+    return Logic::Propositional;
+}
+
+// Picked by timing the whole suite on z3 4.8.12. The plain smt core beat
+// the logic-specific qflia, qfnia and qfbv pipelines on every fragment, and
+// qfnra-nlsat alone does not terminate on some of the div rules.
+Strategy logic_strategy(Logic logic) {
+    switch (logic) {
+        case Logic::Propositional: {
+            return {"cnf sat", "simplify tseitin-cnf sat"};
+        }
+        case Logic::QF_LIA: {
+            return {"solve-eqs smt", "simplify propagate-values solve-eqs smt"};
+        }
+        case Logic::QF_NIA: {
+            return {"smt", "smt"};
+        }
+        case Logic::QF_BV: {
+            return {"simplify smt", "simplify smt"};
+        }
+        default: {
+            return {"default", ""};
+        }
+    }
+}
+
+z3::tactic make_tactic(z3::context &context, const std::string &pipeline) {
+    size_t start = 0, end = pipeline.find(' ');
+    z3::tactic tactic(context, pipeline.substr(0, end).c_str());
+    while (end != std::string::npos) {
+        start = end + 1;
+        end = pipeline.find(' ', start);
+        tactic = tactic & z3::tactic(context, pipeline.substr(start, end - start).c_str());
+    }
+    return tactic;
+}
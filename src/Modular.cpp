@@ -0,0 +1,233 @@
+#include "Modular.h"
+#include "HalideType.h"
+
+// 2^n as an integer numeral
+static z3::expr power_of_two(z3::context &context, unsigned n) {
+    return z3::pw(context.int_val(2), context.int_val(n)).simplify();
+}
+
+ModularWidth::ModularWidth(z3::context &context, unsigned min_width, unsigned max_width)
+    : context(context),
+      power(context.function("pow2", context.int_sort(), context.int_sort())),
+      w(context.int_const("w")), modulus(context), half(context), facts(context) {
+    modulus = Power(w);
+    half = Power(w - 1);
+    facts.push_back(w >= (int)min_width && w <= (int)max_width);
+    facts.push_back(modulus == 2 * half);
+    facts.push_back(half >= power_of_two(context, min_width - 1));
+    facts.push_back(modulus <= power_of_two(context, max_width));
+}
+
+z3::expr ModularWidth::Fresh(const std::string &name) {
+    z3::expr x = context.int_const(name.c_str());
+    facts.push_back(x >= 0 && x < modulus);
+    return x;
+}
+
+z3::expr ModularWidth::Variable(const std::string &name) {
+    return Fresh(name);
+}
+
+z3::expr ModularWidth::Value(int64_t value) {
+    return value >= 0 ? context.int_val(value) : modulus + context.int_val(value);
+}
+
+z3::expr ModularWidth::Power(const z3::expr &k) {
+    uint64_t constant;
+    if (k.is_numeral_u64(constant) && constant < 128) {
+        return power_of_two(context, constant);
+    }
+    bool known = false;
+    for (const z3::expr &exponent : exponents) {
+        known |= z3::eq(exponent, k);
+    }
+    if (!known) {
+        exponents.push_back(k);
+    }
+    return power(k);
+}
+
+z3::expr ModularWidth::Signed(const z3::expr &a) const {
+    return z3::ite(a >= half, a - modulus, a);
+}
+
+z3::expr ModularWidth::Wrap(const z3::expr &x) {
+    z3::expr wrapped = z3::mod(x, modulus);
+    wraps.emplace_back(x, wrapped);
+    return wrapped;
+}
+
+z3::expr ModularWidth::Product(const z3::expr &x, const z3::expr &k) {
+    z3::expr p = Power(k);
+    products.push_back({x, p, x * p});
+    return products.back().term;
+}
+
+z3::expr ModularWidth::Quotient(const z3::expr &x, const z3::expr &k) {
+    z3::expr p = Power(k);
+    quotients.push_back({x, p, x / p});
+    return quotients.back().term;
+}
+
+z3::expr ModularWidth::LessEqual(bool is_signed, const z3::expr &a, const z3::expr &b) const {
+    return is_signed ? Signed(a) <= Signed(b) : a <= b;
+}
+
+z3::expr ModularWidth::Less(bool is_signed, const z3::expr &a, const z3::expr &b) const {
+    return is_signed ? Signed(a) < Signed(b) : a < b;
+}
+
+z3::expr ModularWidth::Negate(const z3::expr &a) {
+    return Wrap(-a);
+}
+
+z3::expr ModularWidth::Multiply(const z3::expr &a, const z3::expr &b) {
+    return Wrap(a * b);
+}
+
+z3::expr ModularWidth::Shl(const z3::expr &a, const z3::expr &b) {
+    return z3::ite(b < w, Wrap(Product(a, b)), context.int_val(0));
+}
+
+z3::expr ModularWidth::Lshr(const z3::expr &a, const z3::expr &b) {
+    return z3::ite(b < w, Quotient(a, b), context.int_val(0));
+}
+
+z3::expr ModularWidth::Ashr(const z3::expr &a, const z3::expr &b) {
+    // div rounds down for positive divisors, as an arithmetic shift does
+    z3::expr sign = z3::ite(a >= half, modulus - 1, context.int_val(0));
+    return z3::ite(b < w, Wrap(Quotient(Signed(a), b)), sign);
+}
+
+z3::expr ModularWidth::BitAnd(const z3::expr &a, const z3::expr &b) {
+    z3::expr r = Fresh("and!" + std::to_string(fresh++));
+    facts.push_back(r <= a && r <= b && r >= a + b - (modulus - 1));
+    return r;
+}
+
+z3::expr ModularWidth::BitOr(const z3::expr &a, const z3::expr &b) {
+    z3::expr r = Fresh("or!" + std::to_string(fresh++));
+    facts.push_back(r >= a && r >= b && r <= a + b);
+    return r;
+}
+
+z3::expr ModularWidth::BitNot(const z3::expr &a) const {
+    return modulus - 1 - a;
+}
+
+z3::expr ModularWidth::LeftShift(const z3::expr &a, const z3::expr &b, bool aIsUint, bool bIsUint) {
+    z3::expr negative = !bIsUint && Signed(b) < 0;
+    if (aIsUint) {
+        // ui_shift_left, or uint_shift_left for an unsigned b
+        return z3::ite(negative, Lshr(a, Negate(b)), Shl(a, b));
+    } else if (bIsUint) {
+        return Shl(a, b);
+    }
+    z3::expr shifted = z3::ite(Signed(a) >= 0, Shl(a, b), Multiply(a, Shl(Value(1), b)));
+    return z3::ite(negative, Ashr(a, Negate(b)), shifted);
+}
+
+z3::expr ModularWidth::RightShift(const z3::expr &a, const z3::expr &b, bool aIsUint, bool bIsUint) {
+    z3::expr shifted = aIsUint ? Lshr(a, b) : Ashr(a, b);
+    if (bIsUint) {
+        return shifted;
+    }
+    return z3::ite(Signed(b) < 0, Shl(a, Negate(b)), shifted);
+}
+
+z3::expr ModularWidth::ShlDropsBits(const z3::expr &a, const z3::expr &b) {
+    return z3::ite(b < w, Product(a, b) >= modulus, a != 0);
+}
+
+z3::expr ModularWidth::WideShl(const z3::expr &i, const z3::expr &j) {
+    // a negative j becomes a shift by far more than 2w; the rules only
+    // shift by less than w, beyond that the value is left open
+    z3::expr beyond = context.int_const(("wide!" + std::to_string(fresh++)).c_str());
+    z3::expr shifted = z3::ite(j < w, Product(Signed(i), j), beyond);
+    return z3::ite(Signed(j) < 0, context.int_val(0), shifted);
+}
+
+z3::expr ModularWidth::SignedOverflowIsUndefined() const {
+    // HalideType::OverflowIsUndefined() with the width left symbolic
+    if (type_semantics() == ScaledTypes) {
+        return context.bool_val(true);
+    }
+    return w >= 32;
+}
+
+z3::expr ModularWidth::LeftShiftOverflows(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool iIsUint,
+                                            bool jIsUint) {
+    z3::expr jpos = jIsUint ? context.bool_val(true) : Signed(j) >= 0;
+    z3::expr pos_bit_count = ShlDropsBits(i, j) && (iIsUint ? context.bool_val(true) : Signed(i) >= 0);
+    if (iIsUint) {
+        return jpos && pos_bit_count;
+    }
+    // below INT_MIN for the width, as Overflow.cpp checks in twice the width
+    z3::expr neg_overflow = WideShl(i, j) < -half;
+    z3::expr sign_change = Signed(i) > 0 && Signed(res) < 0;
+    return SignedOverflowIsUndefined() && jpos && (pos_bit_count || sign_change || neg_overflow);
+}
+
+z3::expr ModularWidth::RightShiftOverflows(const z3::expr &i, const z3::expr &j, const z3::expr &res,
+                                            bool aIsUint) {
+    if (aIsUint) {
+        return context.bool_val(false);
+    }
+    z3::expr sign_change = Signed(i) > 0 && Signed(res) < 0;
+    return SignedOverflowIsUndefined() && Signed(j) < 0 && (ShlDropsBits(i, Negate(j)) || sign_change);
+}
+
+z3::expr_vector ModularWidth::Facts() {
+    z3::expr_vector all(context);
+    for (unsigned f = 0; f < facts.size(); f++) {
+        all.push_back(facts[f]);
+    }
+    for (size_t x = 0; x < exponents.size(); x++) {
+        const z3::expr &k = exponents[x];
+        all.push_back(power(k) >= 1);
+        all.push_back(z3::implies(k >= 0, power(k) >= k + 1));
+        for (size_t y = 0; y < exponents.size(); y++) {
+            const z3::expr &l = exponents[y];
+            if (x == y) {
+                continue;
+            }
+            all.push_back(z3::implies(k >= 0 && k < l, 2 * power(k) <= power(l)));
+            all.push_back(z3::implies(k >= 0 && k + 1 == l, power(l) == 2 * power(k)));
+            all.push_back(z3::implies(k >= 0 && k <= l, z3::mod(power(l), power(k)) == 0));
+        }
+    }
+
+    // z3 does not find these on its own: x * 2^k and x / 2^k keep the sign
+    // of x and grow with it, and with k as far as the sign allows
+    for (const Scaled &a : products) {
+        all.push_back(z3::implies(a.x >= 0, a.term >= a.x));
+        all.push_back(z3::implies(a.x < 0, a.term <= a.x));
+        for (const Scaled &b : products) {
+            if (&a == &b) {
+                continue;
+            }
+            all.push_back(z3::implies(a.x <= b.x && a.power == b.power, a.term <= b.term));
+            all.push_back(z3::implies(a.x >= 0 && a.x <= b.x && a.power <= b.power, a.term <= b.term));
+            all.push_back(z3::implies(a.x <= b.x && b.x < 0 && b.power <= a.power, a.term <= b.term));
+        }
+    }
+    for (const Scaled &a : quotients) {
+        all.push_back(z3::implies(a.x >= 0, a.term >= 0 && a.term <= a.x));
+        all.push_back(z3::implies(a.x < 0, a.term < 0 && a.term >= a.x));
+        for (const Scaled &b : quotients) {
+            if (&a == &b) {
+                continue;
+            }
+            all.push_back(z3::implies(a.x <= b.x && a.power == b.power, a.term <= b.term));
+            all.push_back(z3::implies(a.x >= 0 && a.x <= b.x && b.power <= a.power, a.term <= b.term));
+            all.push_back(z3::implies(a.x <= b.x && b.x < 0 && a.power <= b.power, a.term <= b.term));
+        }
+    }
+    // x mod 2^w for x within one modulus of the range
+    for (const auto &wrap : wraps) {
+        const z3::expr &x = wrap.first, &wrapped = wrap.second;
+        all.push_back(z3::implies(x >= 0 && x < modulus, wrapped == x));
+        all.push_back(z3::implies(x < 0 && x >= -modulus, wrapped == x + modulus));
+    }
+    return all;
+}
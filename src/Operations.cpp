@@ -30,6 +30,52 @@ std::string OpToString(Operation op) {
     }
 }
 
+bool is_commutative(Z3_decl_kind kind) {
+    switch (kind) {
+        case Z3_OP_EQ:
+        case Z3_OP_DISTINCT:
+        case Z3_OP_AND:
+        case Z3_OP_OR:
+        case Z3_OP_XOR:
+        case Z3_OP_ADD:
+        case Z3_OP_MUL:
+        case Z3_OP_BADD:
+        case Z3_OP_BMUL:
+        case Z3_OP_BAND:
+        case Z3_OP_BOR:
+        case Z3_OP_BXOR: {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+
+bool is_min_max(const z3::expr &e) {
+    if (!e.is_app() || e.decl().decl_kind() != Z3_OP_ITE) {
+        return false;
+    }
+    z3::expr condition = e.arg(0);
+    if (!condition.is_app()) {
+        return false;
+    }
+    switch (condition.decl().decl_kind()) {
+        case Z3_OP_LT:
+        case Z3_OP_LE:
+        case Z3_OP_SLT:
+        case Z3_OP_SLEQ:
+        case Z3_OP_ULT:
+        case Z3_OP_ULEQ: {
+            break;
+        }
+        default: {
+            return false;
+        }
+    }
+    z3::expr p = condition.arg(0), q = condition.arg(1);
+    return (z3::eq(e.arg(1), p) && z3::eq(e.arg(2), q)) || (z3::eq(e.arg(1), q) && z3::eq(e.arg(2), p));
+}
 
 z3::expr generate_op(Operation op, z3::expr &i, z3::expr &j) {
     switch (op) {
@@ -0,0 +1,84 @@
+#include "Overflow.h"
+#include "HalideType.h"
+#include "Operations.h"
+
+static OverflowEncoding encoding = ShiftBack;
+
+void set_overflow_encoding(OverflowEncoding new_encoding) {
+    encoding = new_encoding;
+}
+
+OverflowEncoding overflow_encoding() {
+    return encoding;
+}
+
+static const char *encoding_names[] = {"count", "shift", "mul"};
+
+std::string OverflowEncodingToString(OverflowEncoding encoding) {
+    return encoding_names[encoding];
+}
+
+bool ParseOverflowEncoding(const std::string &name, OverflowEncoding &parsed) {
+    for (int e = CountSetBits; e <= MulNoOverflow; e++) {
+        if (name == encoding_names[e]) {
+            parsed = (OverflowEncoding)e;
+            return true;
+        }
+    }
+    return false;
+}
+
+z3::expr shl_drops_bits(const z3::expr &a, const z3::expr &b) {
+    unsigned width = a.get_sort().bv_size();
+    switch (encoding) {
+        case CountSetBits: {
+            return count_set_bits(a, width) != count_set_bits(z3::shl(a, b), width);
+        }
+        case MulNoOverflow: {
+            // 1 << b is 0 from the width on, where the product cannot overflow
+            z3::expr one = a.ctx().bv_val(1, width);
+            return z3::ite(z3::ult(b, width), !z3::bvmul_no_overflow(a, z3::shl(one, b), false), a != 0);
+        }
+        default: {
+            return z3::lshr(z3::shl(a, b), b) != a;
+        }
+    }
+}
+
+z3::expr wide_shl(const z3::expr &a, const z3::expr &b) {
+    unsigned width = a.get_sort().bv_size();
+    return z3::shl(z3::sext(a, width), z3::sext(b, width));
+}
+
+z3::expr left_shift_overflows(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool iIsUint,
+                                bool jIsUint) {
+    unsigned width = i.get_sort().bv_size();
+    z3::expr jpos = (jIsUint || (j >= 0));
+    z3::expr drops = shl_drops_bits(i, j);
+    if (iIsUint) {
+        return jpos && drops;
+    }
+    // a signed type that wraps cannot overflow
+    if (!HalideType::Int(width).OverflowIsUndefined()) {
+        return i.ctx().bool_val(false);
+    }
+    z3::expr pos_bit_count = drops && (i >= 0);
+    // INT_MIN for width, sign extended to twice the width
+    z3::expr int_min = z3::sext(z3::shl(i.ctx().bv_val(1, width), i.ctx().bv_val(width - 1, width)), width);
+    z3::expr neg_overflow = wide_shl(i, j) < int_min;
+    // sign change on an integer is overflow
+    z3::expr sign_change = (i > 0) && res < 0;
+    return jpos && (pos_bit_count || sign_change || neg_overflow);
+}
+
+z3::expr right_shift_overflows(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool aIsUint) {
+    // overflow is only UB for Int(32) and Int(64), see HalideType
+    if (!HalideType{!aIsUint, i.get_sort().bv_size()}.OverflowIsUndefined()) {
+        return i.ctx().bool_val(false);
+    }
+    z3::expr jneg = (j < 0);
+    z3::expr bad_bit_count = shl_drops_bits(i, -j);
+    // sign change on an integer is overflow
+    z3::expr sign_change = (i > 0) && res < 0;
+    return jneg && (bad_bit_count || sign_change);
+}
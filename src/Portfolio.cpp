@@ -0,0 +1,133 @@
+#include "Portfolio.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+const std::vector<Strategy> &portfolio_strategies() {
+    static const std::vector<Strategy> strategies = {
+        {"default", ""},
+        {"qfnia", "qfnia"},
+        {"nlsat", "qfnra-nlsat"},
+        // sound for sat only, an unsat of the bounded problem comes back
+        // as unknown (incomplete)
+        {"bit-blast", "simplify nla2bv simplify bit-blast sat"},
+    };
+    return strategies;
+}
+
+struct Entrant {
+    const Strategy *strategy;
+    std::unique_ptr<z3::context> context;   // null for the query's own solver
+    std::unique_ptr<z3::solver> solver;
+    z3::check_result status = z3::unknown;
+    std::string reason_unknown;
+    bool finished = false;
+};
+
+CheckResult solve_portfolio(z3::solver &solver, const z3::expr_vector &assumptions) {
+    std::vector<std::unique_ptr<Entrant>> entrants;
+    for (const Strategy &strategy : portfolio_strategies()) {
+        std::unique_ptr<Entrant> entrant(new Entrant());
+        entrant->strategy = &strategy;
+        if (strategy.tactic.empty()) {
+            entrant->solver.reset(new z3::solver(solver));
+        } else {
+            // translate here, before any thread starts using the query's context
+            entrant->context.reset(new z3::context());
+            z3::context &context = *entrant->context;
+            try {
+                entrant->solver.reset(new z3::solver(make_tactic(context, strategy.tactic).mk_solver()));
+            } catch (const z3::exception &e) {
+                continue;
+            }
+            entrant->solver->add(z3::expr_vector(context, solver.assertions()));
+            // tactic solvers take assumptions as plain assertions
+            entrant->solver->add(z3::expr_vector(context, assumptions));
+        }
+        entrants.push_back(std::move(entrant));
+    }
+
+    std::mutex mutex;
+    std::condition_variable changed;
+    Entrant *winner = nullptr;
+    size_t running = entrants.size();
+
+    std::vector<std::thread> threads;
+    for (std::unique_ptr<Entrant> &e : entrants) {
+        Entrant *entrant = e.get();
+        threads.emplace_back([&, entrant] {
+            z3::check_result status = z3::unknown;
+            std::string reason;
+            try {
+                if (entrant->context) {
+                    status = entrant->solver->check();
+                } else {
+                    status = assumptions.empty() ? entrant->solver->check() : entrant->solver->check(assumptions);
+                }
+                if (status == z3::unknown) {
+                    reason = entrant->solver->reason_unknown();
+                }
+            } catch (const z3::exception &ex) {
+                reason = ex.msg();
+            }
+
+            std::lock_guard<std::mutex> lock(mutex);
+            entrant->status = status;
+            entrant->reason_unknown = reason;
+            entrant->finished = true;
+            if (status != z3::unknown && winner == nullptr) {
+                winner = entrant;
+            }
+            running--;
+            changed.notify_all();
+        });
+    }
+
+    bool interrupted_query = false;
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        changed.wait(lock, [&] { return winner != nullptr || running == 0; });
+        // an interrupt that arrives before a solver has started is lost, so
+        // keep interrupting until every loser has given up
+        while (running > 0) {
+            for (std::unique_ptr<Entrant> &entrant : entrants) {
+                if (!entrant->finished) {
+                    z3::context &context = entrant->context ? *entrant->context : solver.ctx();
+                    context.interrupt();
+                    interrupted_query |= !entrant->context;
+                }
+            }
+            changed.wait_for(lock, std::chrono::milliseconds(10));
+        }
+    }
+    for (std::thread &thread : threads) {
+        thread.join();
+    }
+    if (interrupted_query) {
+        // an interrupt that landed after the query's solver returned is still
+        // pending and would cancel its next push, a check clears it
+        z3::solver(solver.ctx()).check();
+    }
+
+    CheckResult result;
+    if (winner == nullptr) {
+        // report why the query's own solver gave up
+        result.reason_unknown = entrants.front()->reason_unknown;
+        return result;
+    }
+
+    result.status = winner->status;
+    result.solved_by = winner->strategy->name;
+    if (result.status == z3::sat) {
+        if (winner->context) {
+            z3::model model = winner->solver->get_model();
+            result.model = z3::model(model, solver.ctx(), z3::model::translate());
+        } else {
+            result.model = solver.get_model();
+        }
+    }
+    return result;
+}
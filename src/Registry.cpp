@@ -0,0 +1,113 @@
+#include "Registry.h"
+#include "ContextPool.h"
+
+#include "z3++.h"
+#include <algorithm>
+#include <fnmatch.h>
+#include <iostream>
+
+static thread_local std::ostream *current_output = &std::cout;
+
+bool Rule::HasTag(const std::string &tag) const {
+    return std::find(tags.begin(), tags.end(), tag) != tags.end();
+}
+
+void Rule::Run() const {
+    if (family_function) {
+        family_function(rule_context());
+    } else {
+        function();
+    }
+}
+
+RuleEntry::RuleEntry(const char *function_name, RuleFunction function, std::vector<std::string> tags,
+                        const char *file)
+    : function_name(function_name), file(file), function(function), tags(std::move(tags)) {}
+
+RuleEntry::RuleEntry(const char *function_name, FamilyRuleFunction function, std::vector<std::string> tags,
+                        const char *file)
+    : function_name(function_name), file(file), family_function(function), tags(std::move(tags)) {}
+
+RuleEntry::RuleEntry(const char *function_name, WidthFunctions widths, unsigned width,
+                        std::vector<std::string> tags, const char *file)
+    : function_name(function_name), file(file), tags(std::move(tags)), width(width), widths(std::move(widths)) {
+    for (const auto &instance : this->widths) {
+        if (instance.first == width) {
+            function = instance.second;
+        }
+    }
+}
+
+std::vector<Rule> &all_rules() {
+    // function-local so that registration from other translation units
+    // does not depend on static initialization order
+    static std::vector<Rule> rules;
+    return rules;
+}
+
+RuleGroup::RuleGroup(std::string group, std::string op, std::vector<std::string> tags,
+                        std::initializer_list<RuleEntry> entries) {
+    for (const RuleEntry &entry : entries) {
+        std::string test = entry.function_name;
+        if (test.rfind("test_", 0) == 0) {
+            test = test.substr(5);
+        }
+
+        Rule rule;
+        rule.name = group + "/" + test;
+        rule.op = op;
+        rule.tags = tags;
+        rule.tags.insert(rule.tags.end(), entry.tags.begin(), entry.tags.end());
+        rule.function = entry.function;
+        rule.family_function = entry.family_function;
+        rule.file = entry.file;
+        rule.function_name = entry.function_name;
+        rule.width = entry.width;
+        rule.widths = entry.widths;
+        if (entry.family_function) {
+            rule.family = group;
+        }
+        all_rules().push_back(rule);
+    }
+}
+
+bool RuleFilter::Matches(const Rule &rule) const {
+    if (!ops.empty() && std::find(ops.begin(), ops.end(), rule.op) == ops.end()) {
+        return false;
+    }
+
+    if (!tags.empty() && std::none_of(tags.begin(), tags.end(),
+                            [&](const std::string &tag) { return rule.HasTag(tag); })) {
+        return false;
+    }
+
+    if (!globs.empty() && std::none_of(globs.begin(), globs.end(),
+                            [&](const std::string &glob) { return fnmatch(glob.c_str(), rule.name.c_str(), 0) == 0; })) {
+        return false;
+    }
+
+    if (rule.HasTag("disabled") && !include_disabled) {
+        return std::find(tags.begin(), tags.end(), "disabled") != tags.end();
+    }
+    return true;
+}
+
+std::vector<const Rule *> select_rules(const RuleFilter &filter) {
+    std::vector<const Rule *> selected;
+    for (const Rule &rule : all_rules()) {
+        if (filter.Matches(rule)) {
+            selected.push_back(&rule);
+        }
+    }
+    return selected;
+}
+
+std::ostream &rule_output() {
+    return *current_output;
+}
+
+std::ostream *set_rule_output(std::ostream *output) {
+    std::ostream *previous = current_output;
+    current_output = output;
+    return previous;
+}
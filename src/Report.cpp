@@ -0,0 +1,110 @@
+#include "Report.h"
+
+#include <iomanip>
+#include <sstream>
+
+static bool timing = false;
+static thread_local ReportTally *tally = nullptr;
+
+void set_report_timing(bool enabled) {
+    timing = enabled;
+}
+
+bool report_timing() {
+    return timing;
+}
+
+ReportTally *set_report_tally(ReportTally *new_tally) {
+    ReportTally *previous = tally;
+    tally = new_tally;
+    return previous;
+}
+
+static void count(const CheckResult &result, bool verdict) {
+    if (tally == nullptr) {
+        return;
+    }
+    tally->seconds += result.seconds;
+    if (!verdict) {
+        return;
+    }
+    if (result.status == z3::unsat) {
+        tally->proved++;
+    } else if (result.status == z3::sat) {
+        tally->failed++;
+    } else if (tally->unknown++ == 0) {
+        tally->reason_unknown = result.reason_unknown;
+    }
+}
+
+// e.g. " [QF_NIA, qfnia, 0.012s]", or nothing
+static void report_time(const CheckResult &result) {
+    std::ostringstream notes;
+    if (!result.logic.empty()) {
+        notes << result.logic;
+    }
+    if (!result.solved_by.empty()) {
+        notes << (notes.tellp() > 0 ? ", " : "") << result.solved_by;
+    }
+    if (timing) {
+        notes << (notes.tellp() > 0 ? ", " : "") << (result.cached ? "cached, " : "")
+                << (result.shared ? "shared, " : "");
+        notes << std::fixed << std::setprecision(3) << result.seconds << "s";
+    }
+    if (notes.tellp() > 0) {
+        rule_output() << " [" << notes.str() << "]";
+    }
+}
+
+static void report_stale(const CheckResult &result) {
+    if (result.stale_cache) {
+        rule_output() << "WARNING: the proof cache disagreed with this verdict and was corrected" << std::endl;
+    }
+}
+
+void report(const CheckResult &result) {
+    count(result, true);
+    report_stale(result);
+    if (result.status == z3::unsat) {
+        rule_output() << "proved";
+        report_time(result);
+        rule_output() << std::endl << result.statement;
+    } else if (result.status == z3::unknown) {
+        rule_output() << "ERROR: z3 unable to prove or disprove (" << result.reason_unknown << ")";
+        report_time(result);
+        rule_output() << std::endl << result.statement;
+    } else { // sat
+        rule_output() << "failed to prove";
+        report_time(result);
+        rule_output() << std::endl << result.counterexample;
+    }
+}
+
+void report_tightness(const CheckResult &result) {
+    // whether a bound is tight says nothing about whether the rule holds
+    count(result, false);
+    if (result.stale_cache) {
+        rule_output() << " (cache corrected)";
+    }
+    if (result.status == z3::unsat) {
+        rule_output() << " NOT tight.";
+    } else if (result.status == z3::unknown) {
+        rule_output() << " Unknown (" << result.reason_unknown << ").";
+    } else {
+        rule_output() << " Tight.";
+    }
+    report_time(result);
+    rule_output() << std::endl;
+}
+
+void report(const TightnessResult &result) {
+    if (result.lower) {
+        rule_output() << "Checking lower bound tightness...";
+        report_tightness(*result.lower);
+    }
+
+    if (result.upper) {
+        rule_output() << "Checking upper bound tightness...";
+        report_tightness(*result.upper);
+    }
+}
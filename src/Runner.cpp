@@ -0,0 +1,359 @@
+#include "Runner.h"
+#include "Changes.h"
+#include "Check.h"
+#include "ContextPool.h"
+#include "HalideType.h"
+#include "Overflow.h"
+#include "Report.h"
+#include "ShiftEncoding.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <sstream>
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+ThreadPool::ThreadPool(unsigned threads) {
+    for (unsigned t = 0; t < threads; t++) {
+        workers.emplace_back([this] { Work(); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::Submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+    }
+    changed.notify_all();
+}
+
+// expects the lock to be held, returns with it held
+bool ThreadPool::RunOne(std::unique_lock<std::mutex> &lock) {
+    if (tasks.empty()) {
+        return false;
+    }
+    std::function<void()> task = std::move(tasks.front());
+    tasks.pop_front();
+    lock.unlock();
+    task();
+    lock.lock();
+    return true;
+}
+
+void ThreadPool::Work() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (!stopping || !tasks.empty()) {
+        if (!RunOne(lock)) {
+            changed.wait(lock);
+        }
+    }
+}
+
+// Collects rule outputs, writes them to std::cout in rule order as soon as
+// each prefix of the rules is done, and records those of rules that ran to
+// completion in options.results_dir.
+class Reports {
+public:
+    Reports(const std::vector<const Rule *> &rules, const RunOptions &options);
+
+    // the rules that have to run, the rest were replayed from recorded results
+    const std::vector<size_t> &Pending() const { return pending; }
+
+    // complete is false if the runner had to step in, e.g. on a z3 exception
+    // or a killed worker; such output is printed but not recorded
+    void Finish(size_t r, const std::string &output, bool complete);
+
+private:
+    const std::vector<const Rule *> &rules;
+    std::string results_dir;
+    std::vector<std::string> fingerprints;
+    std::vector<std::string> outputs;
+    std::vector<bool> finished;
+    std::vector<size_t> pending;
+    size_t next_print = 0;
+    std::mutex mutex;
+};
+
+// what besides the sources can change a rule's report
+static std::string run_parameters(const RunOptions &options) {
+    std::ostringstream parameters;
+    const SolveOptions &solve = solve_options();
+    parameters << "timeout=" << options.query_timeout_ms << " classify=" << solve.classify
+                << " portfolio=" << solve.portfolio << " timing=" << report_timing()
+                << " dual=" << solve.dual << " dual_budget=" << solve.dual_budget_ms
+                << " dedup=" << solve.dedup << " recheck=" << solve.recheck << " families=" << options.families
+                << " overflow=" << OverflowEncodingToString(overflow_encoding())
+                << " types=" << TypeSemanticsToString(type_semantics()) << " shifts=" << ShiftEncodingsToString();
+    return parameters.str();
+}
+
+Reports::Reports(const std::vector<const Rule *> &rules, const RunOptions &options)
+    : rules(rules), results_dir(options.results_dir), fingerprints(rules.size()),
+        outputs(rules.size()), finished(rules.size(), false) {
+    std::string parameters = run_parameters(options);
+    std::vector<size_t> replayed;
+    for (size_t r = 0; r < rules.size(); r++) {
+        std::string output;
+        if (!results_dir.empty()) {
+            fingerprints[r] = rule_fingerprint(*rules[r], parameters);
+        }
+        if (options.only_changed && load_rule_report(results_dir, *rules[r], fingerprints[r], output)) {
+            outputs[r] = output;
+            replayed.push_back(r);
+        } else {
+            pending.push_back(r);
+        }
+    }
+    if (options.only_changed) {
+        std::cerr << pending.size() << " of " << rules.size() << " rules changed since their last run"
+                    << std::endl;
+    }
+    for (size_t r : replayed) {
+        finished[r] = true;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    while (next_print < rules.size() && finished[next_print]) {
+        std::cout << outputs[next_print++] << std::flush;
+    }
+}
+
+void Reports::Finish(size_t r, const std::string &output, bool complete) {
+    if (complete && !results_dir.empty()) {
+        store_rule_report(results_dir, *rules[r], fingerprints[r], output);
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    outputs[r] = output;
+    finished[r] = true;
+    while (next_print < rules.size() && finished[next_print]) {
+        std::cout << outputs[next_print] << std::flush;
+        outputs[next_print++].clear();
+    }
+}
+
+// consecutive pending rules of one family form a batch, every other rule is
+// a batch of its own
+static std::vector<std::vector<size_t>> make_batches(const std::vector<const Rule *> &rules,
+                                                        const std::vector<size_t> &pending, bool families) {
+    std::vector<std::vector<size_t>> batches;
+    for (size_t r : pending) {
+        if (families && !batches.empty() && !rules[r]->family.empty() &&
+                rules[batches.back().back()]->family == rules[r]->family) {
+            batches.back().push_back(r);
+        } else {
+            batches.push_back({r});
+        }
+    }
+    return batches;
+}
+
+// runs the rules of a batch in order, each reporting to its own buffer
+static void run_batch(const std::vector<const Rule *> &rules, const std::vector<size_t> &batch,
+                        Reports &reports) {
+    std::unique_ptr<Family> family;
+    if (batch.size() > 1) {
+        family.reset(new Family(rule_context()));
+    }
+
+    for (size_t r : batch) {
+        std::ostringstream output;
+        std::ostream *previous = set_rule_output(&output);
+        bool complete = true;
+        try {
+            if (family) {
+                rules[r]->family_function(family->context);
+            } else {
+                rules[r]->Run();
+            }
+        } catch (const z3::exception &e) {
+            rule_output() << "ERROR: z3 exception in " << rules[r]->name << ": " << e.msg() << std::endl;
+            complete = false;
+        }
+        set_rule_output(previous);
+        reports.Finish(r, output.str(), complete);
+    }
+}
+
+static void run_rules_threaded(const std::vector<const Rule *> &rules, unsigned jobs, const RunOptions &options,
+                                Reports &reports) {
+    // the pool finishes every batch before it is destroyed
+    ThreadPool pool(jobs);
+    for (const std::vector<size_t> &batch : make_batches(rules, reports.Pending(), options.families)) {
+        pool.Submit([&, batch] { run_batch(rules, batch, reports); });
+    }
+}
+
+struct Worker {
+    pid_t pid;
+    int fd;
+    size_t rule;
+    std::chrono::steady_clock::time_point deadline;
+    bool killed = false;
+};
+
+// runs in the forked child, never returns
+static void run_worker(const Rule *rule, int fd, const RunOptions &options) {
+    dup2(fd, STDOUT_FILENO);
+    close(fd);
+
+    if (options.memory_mb != 0) {
+        struct rlimit limit;
+        limit.rlim_cur = limit.rlim_max = (rlim_t)options.memory_mb << 20;
+        setrlimit(RLIMIT_AS, &limit);
+    }
+
+    int status = 0;
+    try {
+        rule->Run();
+    } catch (const z3::exception &e) {
+        std::cout << "ERROR: z3 exception in " << rule->name << ": " << e.msg() << std::endl;
+        status = 1;
+    } catch (const std::bad_alloc &) {
+        std::cout << "ERROR: " << rule->name << " ran out of memory" << std::endl;
+        status = 1;
+    }
+    std::cout << std::flush;
+    // skip static destructors, they belong to the parent
+    _exit(status);
+}
+
+static std::string describe_exit(const Rule *rule, int status, bool killed, const RunOptions &options) {
+    std::ostringstream message;
+    if (killed) {
+        message << "ERROR: " << rule->name << " exceeded the " << options.rule_timeout_s
+                << "s wall-clock limit and was killed" << std::endl;
+    } else if (WIFSIGNALED(status)) {
+        message << "ERROR: " << rule->name << " was terminated by signal " << WTERMSIG(status)
+                << " (" << strsignal(WTERMSIG(status)) << ")";
+        if (options.memory_mb != 0) {
+            message << ", memory limit " << options.memory_mb << " MB";
+        }
+        message << std::endl;
+    }
+    return message.str();
+}
+
+static void run_rules_isolated(const std::vector<const Rule *> &rules, unsigned jobs, const RunOptions &options,
+                                Reports &reports) {
+    const std::vector<size_t> &pending = reports.Pending();
+    std::vector<std::string> outputs(rules.size());
+    std::vector<Worker> running;
+    size_t next_rule = 0;
+
+    while (next_rule < pending.size() || !running.empty()) {
+        while (running.size() < std::max(jobs, 1u) && next_rule < pending.size()) {
+            size_t r = pending[next_rule++];
+            int fds[2];
+            // the child would flush anything still buffered a second time
+            std::cout << std::flush;
+            pid_t pid = -1;
+            if (pipe(fds) == 0) {
+                pid = fork();
+                if (pid == 0) {
+                    close(fds[0]);
+                    run_worker(rules[r], fds[1], options);
+                }
+                close(fds[1]);
+                if (pid < 0) {
+                    close(fds[0]);
+                }
+            }
+            if (pid < 0) {
+                reports.Finish(r, "ERROR: could not start a worker for " + rules[r]->name + ": " + strerror(errno) + "\n",
+                                false);
+                continue;
+            }
+
+            Worker worker;
+            worker.pid = pid;
+            worker.fd = fds[0];
+            worker.rule = r;
+            worker.deadline = std::chrono::steady_clock::now() + std::chrono::seconds(options.rule_timeout_s);
+            running.push_back(worker);
+        }
+
+        std::vector<pollfd> polled;
+        int wait_ms = -1;
+        auto now = std::chrono::steady_clock::now();
+        for (const Worker &worker : running) {
+            polled.push_back({worker.fd, POLLIN, 0});
+            if (options.rule_timeout_s != 0 && !worker.killed) {
+                auto left = std::chrono::duration_cast<std::chrono::milliseconds>(worker.deadline - now).count();
+                left = std::max<long long>(left, 0);
+                wait_ms = (wait_ms < 0) ? left : std::min<long long>(wait_ms, left);
+            }
+        }
+        if (!polled.empty() && poll(polled.data(), polled.size(), wait_ms) < 0 && errno != EINTR) {
+            perror("poll");
+            break;
+        }
+
+        now = std::chrono::steady_clock::now();
+        for (size_t w = running.size(); w-- > 0;) {
+            Worker &worker = running[w];
+            if (polled[w].revents != 0) {
+                char buffer[4096];
+                ssize_t n = read(worker.fd, buffer, sizeof(buffer));
+                if (n > 0) {
+                    outputs[worker.rule].append(buffer, n);
+                } else if (n == 0 || errno != EINTR) {
+                    // end of output, the worker is done
+                    int status = 0;
+                    close(worker.fd);
+                    waitpid(worker.pid, &status, 0);
+                    std::string &output = outputs[worker.rule];
+                    std::string exit = describe_exit(rules[worker.rule], status, worker.killed, options);
+                    if (!exit.empty() && !output.empty() && output.back() != '\n') {
+                        output += "\n";
+                    }
+                    output += exit;
+                    bool complete = !worker.killed && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+                    reports.Finish(worker.rule, output, complete);
+                    running.erase(running.begin() + w);
+                    continue;
+                }
+            }
+            if (options.rule_timeout_s != 0 && !worker.killed && now >= worker.deadline) {
+                kill(worker.pid, SIGKILL);
+                worker.killed = true;
+            }
+        }
+    }
+}
+
+void run_rules(const std::vector<const Rule *> &rules, unsigned jobs, const RunOptions &options) {
+    if (options.query_timeout_ms != 0) {
+        // picked up by every solver created from here on
+        z3::set_param("timeout", (int)options.query_timeout_ms);
+        reset_rule_contexts();
+    }
+
+    Reports reports(rules, options);
+    if (options.isolate) {
+        run_rules_isolated(rules, jobs, options, reports);
+    } else if (jobs > 1) {
+        run_rules_threaded(rules, jobs, options, reports);
+    } else {
+        for (const std::vector<size_t> &batch : make_batches(rules, reports.Pending(), options.families)) {
+            run_batch(rules, batch, reports);
+        }
+    }
+}
@@ -0,0 +1,206 @@
+#include "ShiftEncoding.h"
+#include "Operations.h"
+
+#include <map>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+struct Encodings {
+    ShiftEncoding all = BarrelShift;
+    // (is_signed, bits) -> encoding, where it differs from all
+    std::map<std::pair<bool, unsigned>, ShiftEncoding> types;
+};
+
+Encodings encodings;
+
+const char *encoding_names[] = {"barrel", "chain", "mul", "split"};
+
+enum Direction {
+    Shl = 0,
+    Lshr,
+    Ashr
+};
+
+// the direction of a shift by a non-negative amount, and of one by a
+// negative amount, which only a signed amount has
+Direction positive_direction(bool left, bool aIsUint) {
+    return left ? Shl : (aIsUint ? Lshr : Ashr);
+}
+
+Direction negative_direction(bool left, bool aIsUint) {
+    return left ? (aIsUint ? Lshr : Ashr) : Shl;
+}
+
+// a shifted by the constant k, 0 <= k < width, as extracts and extensions
+z3::expr shift_by(const z3::expr &a, unsigned k, Direction direction) {
+    unsigned width = a.get_sort().bv_size();
+    if (k == 0) {
+        return a;
+    }
+    switch (direction) {
+        case Shl:
+            return z3::concat(a.extract(width - 1 - k, 0), a.ctx().bv_val(0, k));
+        case Lshr:
+            return z3::zext(a.extract(width - 1, k), k);
+        default:
+            return z3::sext(a.extract(width - 1, k), k);
+    }
+}
+
+// a shifted by the width or more
+z3::expr shift_beyond(const z3::expr &a, Direction direction) {
+    unsigned width = a.get_sort().bv_size();
+    // every bit is the sign bit from width - 1 on
+    return direction == Ashr ? shift_by(a, width - 1, Ashr) : a.ctx().bv_val(0, width);
+}
+
+// a shifted by b, b read unsigned, one arm per amount below the width
+z3::expr amount_chain(const z3::expr &a, const z3::expr &b, Direction direction) {
+    unsigned width = a.get_sort().bv_size();
+    z3::expr result = shift_beyond(a, direction);
+    for (unsigned k = width; k-- > 0;) {
+        result = z3::ite(b == a.ctx().bv_val(k, width), shift_by(a, k, direction), result);
+    }
+    return result;
+}
+
+// 2^b for b below the width, 0 beyond
+z3::expr power_table(const z3::expr &b) {
+    unsigned width = b.get_sort().bv_size();
+    z3::expr result = b.ctx().bv_val(0, width);
+    for (unsigned k = width; k-- > 0;) {
+        result = z3::ite(b == b.ctx().bv_val(k, width), b.ctx().bv_val((uint64_t)1 << k, width), result);
+    }
+    return result;
+}
+
+// a shifted by b, b read unsigned, as a product or quotient
+z3::expr power_shift(const z3::expr &a, const z3::expr &b, Direction direction) {
+    unsigned width = a.get_sort().bv_size();
+    z3::expr power = power_table(b);
+    if (direction == Shl) {
+        return a * power;
+    }
+    // udiv by 0 is all ones, not what a shift gives
+    auto lshr = [&](const z3::expr &x) {
+        return z3::ite(z3::ult(b, width), z3::udiv(x, power), a.ctx().bv_val(0, width));
+    };
+    if (direction == Lshr) {
+        return lshr(a);
+    }
+    // a negative a shifts in ones, so shift its complement instead
+    return z3::ite(a >= 0, lshr(a), ~lshr(~a));
+}
+
+// what Operations.h builds
+z3::expr barrel_shift(const z3::expr &a, const z3::expr &b, bool left, bool aIsUint, bool bIsUint) {
+    if (left) {
+        if (aIsUint) {
+            return bIsUint ? uint_shift_left(a, b) : ui_shift_left(a, b);
+        }
+        return bIsUint ? iu_shift_left(a, b) : int_shift_left(a, b);
+    }
+    if (aIsUint) {
+        return bIsUint ? uint_shift_right(a, b) : mixed_ui_shift_right(a, b);
+    }
+    return bIsUint ? mixed_iu_shift_right(a, b) : int_shift_right(a, b);
+}
+
+} // namespace
+
+void set_shift_encoding(ShiftEncoding encoding) {
+    encodings.all = encoding;
+    encodings.types.clear();
+}
+
+void set_shift_encoding(const HalideType &type, ShiftEncoding encoding) {
+    encodings.types[{type.is_signed, type.bits}] = encoding;
+}
+
+ShiftEncoding shift_encoding(const HalideType &type) {
+    auto found = encodings.types.find({type.is_signed, type.bits});
+    return found == encodings.types.end() ? encodings.all : found->second;
+}
+
+std::string ShiftEncodingToString(ShiftEncoding encoding) {
+    return encoding_names[encoding];
+}
+
+bool ParseShiftEncoding(const std::string &name, ShiftEncoding &parsed) {
+    for (int e = BarrelShift; e <= SignSplit; e++) {
+        if (name == encoding_names[e]) {
+            parsed = (ShiftEncoding)e;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ParseShiftEncodings(const std::string &spec) {
+    Encodings parsed = encodings;
+    std::istringstream parts(spec);
+    std::string part;
+    while (std::getline(parts, part, ',')) {
+        size_t equals = part.find('=');
+        ShiftEncoding encoding;
+        if (!ParseShiftEncoding(part.substr(equals == std::string::npos ? 0 : equals + 1), encoding)) {
+            return false;
+        }
+        if (equals == std::string::npos) {
+            parsed.all = encoding;
+            parsed.types.clear();
+            continue;
+        }
+        std::string name = part.substr(0, equals);
+        bool known = false;
+        for (const HalideType &type : production_types()) {
+            if (type.Name() == name) {
+                parsed.types[{type.is_signed, type.bits}] = encoding;
+                known = true;
+            }
+        }
+        if (!known) {
+            return false;
+        }
+    }
+    encodings = parsed;
+    return true;
+}
+
+std::string ShiftEncodingsToString() {
+    std::string spec = ShiftEncodingToString(encodings.all);
+    for (const HalideType &type : production_types()) {
+        ShiftEncoding encoding = shift_encoding(type);
+        if (encoding != encodings.all) {
+            spec += "," + type.Name() + "=" + ShiftEncodingToString(encoding);
+        }
+    }
+    return spec;
+}
+
+z3::expr encoded_shift(const z3::expr &a, const z3::expr &b, bool left, bool aIsUint, bool bIsUint,
+                        ShiftEncoding encoding) {
+    if (encoding == BarrelShift) {
+        return barrel_shift(a, b, left, aIsUint, bIsUint);
+    }
+    Direction positive = positive_direction(left, aIsUint);
+    Direction negative = negative_direction(left, aIsUint);
+    if (encoding == SignSplit && !bIsUint) {
+        unsigned width = a.get_sort().bv_size();
+        z3::expr result = z3::ite(b < 0, shift_beyond(a, negative), shift_beyond(a, positive));
+        for (int k = (int)width - 1; k > -(int)width; k--) {
+            z3::expr by_k = (k < 0) ? shift_by(a, -k, negative) : shift_by(a, k, positive);
+            result = z3::ite(b == a.ctx().bv_val(k, width), by_k, result);
+        }
+        return result;
+    }
+    auto shift = [&](const z3::expr &amount, Direction direction) {
+        return encoding == PowerTable ? power_shift(a, amount, direction) : amount_chain(a, amount, direction);
+    };
+    if (bIsUint) {
+        return shift(b, positive);
+    }
+    return z3::ite(b < 0, shift(-b, negative), shift(b, positive));
+}
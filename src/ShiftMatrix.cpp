@@ -0,0 +1,570 @@
+#include "ShiftMatrix.h"
+#include "Check.h"
+#include "Modular.h"
+#include "Operations.h"
+#include "Overflow.h"
+#include "ShiftEncoding.h"
+
+#include "z3++.h"
+#include <algorithm>
+#include <chrono>
+#include <fnmatch.h>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+
+std::string ShiftCase::Name() const {
+    static const char *ends[] = {"", "lower", "upper", "bounded"};
+    static const char *amounts[] = {"nonneg", "negative", "either"};
+    std::ostringstream name;
+    name << (left ? "shift_left/" : "shift_right/") << (a_signed ? "int_" : "uint_") << (b_signed ? "int/" : "uint/")
+            << ends[a_ends] << "/" << amounts[b_amounts];
+    return name.str();
+}
+
+std::vector<ShiftCase> shift_matrix() {
+    std::vector<ShiftCase> cases;
+    for (bool left : {true, false}) {
+        for (bool a_signed : {true, false}) {
+            for (bool b_signed : {true, false}) {
+                for (BoundedEnds a_ends : {LowerEnd, UpperEnd, BothEnds}) {
+                    for (ShiftAmounts b_amounts : {AmountsNonNegative, AmountsNegative, AmountsEitherSign}) {
+                        // an unsigned b is never negative
+                        if (b_signed || b_amounts == AmountsNonNegative) {
+                            cases.push_back({left, a_signed, b_signed, a_ends, b_amounts});
+                        }
+                    }
+                }
+            }
+        }
+    }
+    return cases;
+}
+
+namespace {
+
+// e.g. "u[#x03, _]"
+std::string interval_string(z3::model &model, bool is_signed, BoundedEnds ends, const z3::expr &lower,
+                            const z3::expr &upper) {
+    std::ostringstream out;
+    out << (is_signed ? "" : "u") << "[";
+    out << ((ends & LowerEnd) ? model.eval(lower).to_string() : "_") << ", ";
+    out << ((ends & UpperEnd) ? model.eval(upper).to_string() : "_") << "]";
+    return out.str();
+}
+
+// The semantics of Operations.h and Overflow.h at a fixed width, with
+// the same interface as ModularWidth, so one query builder serves both.
+// Shifts use the given encoding, or the one set for the type if none.
+struct FixedWidth {
+    FixedWidth(z3::context &context, unsigned width, std::optional<ShiftEncoding> encoding)
+        : context(context), width(width), encoding(encoding) {}
+
+    z3::expr Variable(const std::string &name) { return context.bv_const(name.c_str(), width); }
+    z3::expr Value(int64_t value) { return context.bv_val(value, width); }
+    z3::expr Width() { return context.bv_val(width, width); }
+    z3::expr Negate(const z3::expr &a) { return -a; }
+
+    z3::expr LessEqual(bool is_signed, const z3::expr &a, const z3::expr &b) {
+        return is_signed ? (a <= b) : z3::ule(a, b);
+    }
+
+    z3::expr Less(bool is_signed, const z3::expr &a, const z3::expr &b) {
+        return is_signed ? (a < b) : z3::ult(a, b);
+    }
+
+    z3::expr LeftShift(const z3::expr &a, const z3::expr &b, bool aIsUint, bool bIsUint) {
+        return encoding ? encoded_shift(a, b, true, aIsUint, bIsUint, *encoding) : left_shift(a, b, aIsUint, bIsUint);
+    }
+
+    z3::expr RightShift(const z3::expr &a, const z3::expr &b, bool aIsUint, bool bIsUint) {
+        return encoding ? encoded_shift(a, b, false, aIsUint, bIsUint, *encoding)
+                        : right_shift(a, b, aIsUint, bIsUint);
+    }
+
+    z3::expr LeftShiftOverflows(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool iIsUint,
+                                bool jIsUint) {
+        return left_shift_overflows(i, j, res, iIsUint, jIsUint);
+    }
+
+    z3::expr RightShiftOverflows(const z3::expr &i, const z3::expr &j, const z3::expr &res, bool aIsUint) {
+        return right_shift_overflows(i, j, res, aIsUint);
+    }
+
+    z3::context &context;
+    unsigned width;
+    std::optional<ShiftEncoding> encoding;
+};
+
+// the terms of one case's query, for its counterexample
+struct ShiftQuery {
+    explicit ShiftQuery(z3::context &context)
+        : a0(context), a1(context), b0(context), b1(context), emin(context), emax(context), i(context),
+          j(context), res(context), escapes(context) {}
+
+    z3::expr a0, a1, b0, b1, emin, emax, i, j, res;
+    // the goal, left to the caller: some i op j escapes the corner bounds
+    z3::expr escapes;
+};
+
+// a op b as Operations.h defines it, in the type of a
+template<typename Encoding>
+z3::expr apply_shift(Encoding &encoding, const ShiftCase &shift, const z3::expr &a, const z3::expr &b) {
+    return shift.left ? encoding.LeftShift(a, b, !shift.a_signed, !shift.b_signed)
+                        : encoding.RightShift(a, b, !shift.a_signed, !shift.b_signed);
+}
+
+// the overflow check_shift_left and check_shift_right exclude
+template<typename Encoding>
+z3::expr overflows(Encoding &encoding, const ShiftCase &shift, const z3::expr &i, const z3::expr &j,
+                    const z3::expr &res) {
+    if (shift.left) {
+        return encoding.LeftShiftOverflows(i, j, res, !shift.a_signed, !shift.b_signed);
+    }
+    // only a signed j can shift left
+    return shift.b_signed ? encoding.RightShiftOverflows(i, j, res, !shift.a_signed) : i.ctx().bool_val(false);
+}
+
+// Asserts on solver what the case assumes, and returns with it the goal
+// that some i op j escapes the corner bounds. The shift amounts are those
+// check_shift_left and check_shift_right allow.
+template<typename Encoding>
+ShiftQuery build_query(Encoding &encoding, const ShiftCase &shift, z3::solver &solver) {
+    ShiftQuery query(solver.ctx());
+    z3::expr width = encoding.Width();
+    z3::expr minus_width = encoding.Negate(width);
+    z3::expr zero = encoding.Value(0);
+    bool lower = shift.a_ends & LowerEnd, upper = shift.a_ends & UpperEnd;
+    bool as = shift.a_signed, bs = shift.b_signed;
+
+    query.a0 = encoding.Variable("a0");
+    query.a1 = encoding.Variable("a1");
+    query.b0 = encoding.Variable("b0");
+    query.b1 = encoding.Variable("b1");
+    z3::expr &b0 = query.b0, &b1 = query.b1;
+
+    solver.add(encoding.LessEqual(bs, b0, b1));
+    if (shift.b_amounts == AmountsNonNegative) {
+        solver.add(encoding.LessEqual(bs, zero, b0));
+        solver.add(encoding.Less(bs, b1, width));
+    } else {
+        solver.add(encoding.Less(true, minus_width, b0));
+        solver.add(encoding.Less(true, b1, shift.b_amounts == AmountsNegative ? zero : width));
+    }
+
+    // the corners the result is bounded by, none of them overflowing
+    for (bool is_lower : {true, false}) {
+        if (is_lower ? !lower : !upper) {
+            continue;
+        }
+        const z3::expr &a = is_lower ? query.a0 : query.a1;
+        z3::expr by_b0 = apply_shift(encoding, shift, a, b0), by_b1 = apply_shift(encoding, shift, a, b1);
+        solver.add(!overflows(encoding, shift, a, b0, by_b0) && !overflows(encoding, shift, a, b1, by_b1));
+        z3::expr b0_first = encoding.Less(as, by_b0, by_b1);
+        (is_lower ? query.emin : query.emax) =
+            is_lower ? z3::ite(b0_first, by_b0, by_b1) : z3::ite(b0_first, by_b1, by_b0);
+    }
+
+    query.i = encoding.Variable("i");
+    query.j = encoding.Variable("j");
+    z3::expr &i = query.i, &j = query.j;
+    if (shift.left || bs) {
+        solver.add(encoding.Less(true, j, width));
+    }
+    if (!shift.left) {
+        solver.add(bs ? encoding.Less(true, minus_width, j) : encoding.Less(false, j, width));
+    }
+    query.res = apply_shift(encoding, shift, i, j);
+    solver.add(!overflows(encoding, shift, i, j, query.res));
+
+    if (lower) {
+        solver.add(encoding.LessEqual(as, query.a0, i));
+    }
+    if (upper) {
+        solver.add(encoding.LessEqual(as, i, query.a1));
+    }
+    solver.add(encoding.LessEqual(bs, b0, j) && encoding.LessEqual(bs, j, b1));
+    z3::expr_vector inside(solver.ctx());
+    if (lower) {
+        inside.push_back(encoding.LessEqual(as, query.emin, query.res));
+    }
+    if (upper) {
+        inside.push_back(encoding.LessEqual(as, query.res, query.emax));
+    }
+    query.escapes = !z3::mk_and(inside);
+    return query;
+}
+
+// one case at one width, or at every width from min_width up to width at
+// once when symbolic
+struct Instance {
+    const ShiftCase *shift;
+    unsigned width;
+    bool symbolic = false;
+    unsigned min_width = 0, budget_ms = 0;
+    std::optional<ShiftEncoding> encoding;   // the type's if none
+    CheckResult result;
+    std::string error;
+    bool skipped = false;   // the symbolic query already proved the case
+    bool vacuous = false;   // proved only because nothing meets the assumptions
+};
+
+// Is a proof of the case only down to its assumptions, which no i, j and
+// bounds meet? assumed are the assertions before the goal was added.
+bool vacuous(const z3::expr_vector &assumed, unsigned budget_ms = 0) {
+    z3::solver solver(assumed.ctx());
+    if (budget_ms != 0) {
+        z3::params params(assumed.ctx());
+        params.set("timeout", budget_ms);
+        solver.set(params);
+    }
+    solver.add(assumed);
+    return solver.check() == z3::unsat;
+}
+
+// Only unsat means anything here: ModularWidth over-approximates, so a
+// model need not be a counterexample at any width.
+void check_symbolic(Instance &instance) {
+    z3::context context;
+    z3::solver solver(context);
+    z3::params params(context);
+    params.set("timeout", instance.budget_ms);
+    solver.set(params);
+    ModularWidth encoding(context, instance.min_width, instance.width);
+    ShiftQuery query = build_query(encoding, *instance.shift, solver);
+    solver.add(encoding.Facts());
+    z3::expr_vector assumed = solver.assertions();
+    solver.add(query.escapes);
+    instance.result = solve(solver);
+    instance.vacuous = instance.result.status == z3::unsat && vacuous(assumed, instance.budget_ms);
+    instance.result.model.reset();
+    if (instance.result.status == z3::sat) {
+        instance.result.status = z3::unknown;
+        instance.result.reason_unknown = "not a counterexample at a fixed width";
+    }
+}
+
+void check_instance(Instance &instance) {
+    const ShiftCase &shift = *instance.shift;
+    z3::context context;
+    z3::solver solver(context);
+    FixedWidth encoding(context, instance.width, instance.encoding);
+    ShiftQuery query = build_query(encoding, shift, solver);
+    z3::expr_vector assumed = solver.assertions();
+    solver.add(query.escapes);
+
+    const char *op = shift.left ? "<<" : ">>";
+    instance.result = solve(solver, [&](std::ostream &out, z3::model &model) {
+        out << interval_string(model, shift.a_signed, shift.a_ends, query.a0, query.a1) << " " << op << " "
+            << interval_string(model, shift.b_signed, BothEnds, query.b0, query.b1) << std::endl;
+        out << "Resultant bounds: " << interval_string(model, shift.a_signed, shift.a_ends, query.emin, query.emax)
+            << std::endl;
+        out << "Contradiction: " << model.eval(query.i) << " " << op << " " << model.eval(query.j) << " = "
+            << model.eval(query.res) << std::endl;
+    });
+    // the model belongs to this context, the description is all that is kept
+    instance.result.counterexample.Freeze();
+    instance.result.model.reset();
+    instance.vacuous = instance.result.status == z3::unsat && vacuous(assumed);
+}
+
+std::string verdict(const Instance &instance) {
+    if (instance.skipped) {
+        return "-";
+    } else if (!instance.error.empty()) {
+        return "error";
+    } else if (instance.result.status == z3::unsat) {
+        return instance.vacuous ? "vacuous" : "pass";
+    } else if (instance.result.status == z3::sat) {
+        return "FAIL";
+    }
+    const std::string &reason = instance.result.reason_unknown;
+    bool timeout = reason.find("timeout") != std::string::npos || reason.find("canceled") != std::string::npos;
+    if (instance.symbolic) {
+        return "open";
+    }
+    return timeout ? "timeout" : "unknown";
+}
+
+// the cases whose name matches one of globs, all of them if there are none
+std::vector<ShiftCase> select_cases(const std::vector<std::string> &globs) {
+    std::vector<ShiftCase> cases;
+    for (const ShiftCase &shift : shift_matrix()) {
+        std::string name = shift.Name();
+        if (globs.empty() || std::any_of(globs.begin(), globs.end(), [&](const std::string &glob) {
+                return fnmatch(glob.c_str(), name.c_str(), 0) == 0;
+            })) {
+            cases.push_back(shift);
+        }
+    }
+    return cases;
+}
+
+} // namespace
+
+// every instance in batch on a pool of `jobs` threads, waiting for all of them
+void run_instances(const std::vector<Instance *> &batch, unsigned jobs) {
+    ThreadPool pool(std::max(jobs, 1u));
+    for (Instance *instance : batch) {
+        pool.Submit([instance] {
+            try {
+                instance->symbolic ? check_symbolic(*instance) : check_instance(*instance);
+            } catch (const z3::exception &e) {
+                instance->error = e.msg();
+            }
+        });
+    }
+}
+
+void run_shift_matrix(const std::vector<std::string> &globs, const std::vector<unsigned> &widths, unsigned jobs,
+                        const RunOptions &run_options, unsigned symbolic_budget_ms) {
+    if (run_options.query_timeout_ms != 0) {
+        z3::set_param("timeout", (int)run_options.query_timeout_ms);
+    }
+
+    std::vector<ShiftCase> cases = select_cases(globs);
+    unsigned min_width = *std::min_element(widths.begin(), widths.end());
+    unsigned max_width = *std::max_element(widths.begin(), widths.end());
+
+    // narrow widths first, as in a sweep
+    std::vector<Instance> instances;
+    for (unsigned width : widths) {
+        for (const ShiftCase &shift : cases) {
+            instances.push_back({&shift, width});
+        }
+    }
+    auto at = [&](size_t c, unsigned width) -> Instance & {
+        size_t w = std::find(widths.begin(), widths.end(), width) - widths.begin();
+        return instances[w * cases.size() + c];
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Instance> symbolic;
+    std::vector<Instance *> batch;
+    if (symbolic_budget_ms != 0) {
+        // the narrowest width refutes broken cases in milliseconds, the
+        // cases that survive it are tried at every width at once, and the
+        // other widths are only checked one by one where that fails
+        for (size_t c = 0; c < cases.size(); c++) {
+            batch.push_back(&at(c, min_width));
+        }
+        run_instances(batch, jobs);
+        batch.clear();
+
+        for (size_t c = 0; c < cases.size(); c++) {
+            Instance instance{&cases[c], max_width};
+            instance.symbolic = true;
+            instance.min_width = min_width;
+            instance.budget_ms = symbolic_budget_ms;
+            instance.skipped = at(c, min_width).result.status != z3::unsat;
+            symbolic.push_back(instance);
+        }
+        for (Instance &instance : symbolic) {
+            if (!instance.skipped) {
+                batch.push_back(&instance);
+            }
+        }
+        run_instances(batch, jobs);
+        batch.clear();
+
+        for (size_t c = 0; c < cases.size(); c++) {
+            for (unsigned width : widths) {
+                if (width == min_width) {
+                    continue;
+                } else if (symbolic[c].result.status == z3::unsat && !symbolic[c].vacuous) {
+                    at(c, width).skipped = true;
+                } else {
+                    batch.push_back(&at(c, width));
+                }
+            }
+        }
+    } else {
+        for (Instance &instance : instances) {
+            batch.push_back(&instance);
+        }
+    }
+    run_instances(batch, jobs);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t name_width = 4;
+    for (const ShiftCase &shift : cases) {
+        name_width = std::max(name_width, shift.Name().size());
+    }
+    const int cell_width = 15;
+
+    std::cout << std::left << std::setw(name_width + 2) << "case";
+    if (!symbolic.empty()) {
+        std::cout << std::setw(cell_width) << (std::to_string(min_width) + "-" + std::to_string(max_width) + " bits");
+    }
+    for (size_t w = 0; w < widths.size(); w++) {
+        bool last = (w + 1 == widths.size());
+        std::cout << std::setw(last ? 0 : cell_width) << (std::to_string(widths[w]) + " bits");
+    }
+    std::cout << std::endl;
+
+    auto cell = [](const Instance &instance) {
+        std::ostringstream text;
+        text << verdict(instance);
+        if (!instance.skipped) {
+            text << " " << std::fixed << std::setprecision(3) << instance.result.seconds << "s";
+        }
+        return text.str();
+    };
+    for (size_t c = 0; c < cases.size(); c++) {
+        std::cout << std::setw(name_width + 2) << cases[c].Name();
+        if (!symbolic.empty()) {
+            std::cout << std::setw(cell_width) << cell(symbolic[c]);
+        }
+        for (size_t w = 0; w < widths.size(); w++) {
+            bool last = (w + 1 == widths.size());
+            std::cout << std::setw(last ? 0 : cell_width) << cell(instances[w * cases.size() + c]);
+        }
+        std::cout << std::endl;
+    }
+
+    unsigned passed = 0, failed = 0, unmet = 0, other = 0, queries = 0;
+    for (const Instance &instance : instances) {
+        std::string outcome = verdict(instance);
+        if (!instance.skipped) {
+            queries++;
+            (outcome == "pass" ? passed : outcome == "FAIL" ? failed : outcome == "vacuous" ? unmet : other)++;
+        }
+    }
+    std::cout << std::right;
+    if (!symbolic.empty()) {
+        unsigned proved = std::count_if(symbolic.begin(), symbolic.end(), [](const Instance &instance) {
+            return instance.result.status == z3::unsat && !instance.vacuous;
+        });
+        std::cout << proved << " of " << symbolic.size() << " cases proved at every width from " << min_width
+                    << " to " << max_width << " bits at once, ";
+    }
+    std::cout << passed << " passed, " << failed << " failed, " << unmet << " vacuous, " << other
+                << " timed out or errors, of " << queries << " queries [" << std::fixed << std::setprecision(3) << seconds << "s]"
+                << std::endl;
+
+    for (size_t c = 0; c < cases.size(); c++) {
+        for (size_t w = 0; w < widths.size(); w++) {
+            const Instance &instance = instances[w * cases.size() + c];
+            if (!instance.error.empty()) {
+                std::cout << std::endl << "== " << cases[c].Name() << " at " << widths[w] << " bits ==" << std::endl;
+                std::cout << "ERROR: z3 exception: " << instance.error << std::endl;
+                break;
+            } else if (instance.result.status == z3::sat) {
+                std::cout << std::endl << "== " << cases[c].Name() << " at " << widths[w] << " bits ==" << std::endl;
+                std::cout << instance.result.counterexample;
+                break;
+            }
+        }
+    }
+}
+
+void run_shift_benchmark(const std::vector<std::string> &globs, const std::vector<unsigned> &widths, unsigned jobs,
+                            const RunOptions &run_options) {
+    if (run_options.query_timeout_ms != 0) {
+        z3::set_param("timeout", (int)run_options.query_timeout_ms);
+    }
+    const std::vector<ShiftEncoding> encodings = {BarrelShift, AmountChain, PowerTable, SignSplit};
+    std::vector<ShiftCase> cases = select_cases(globs);
+
+    // encoding-major, so the same case is never solved twice at once
+    std::vector<Instance> instances;
+    for (ShiftEncoding encoding : encodings) {
+        for (unsigned width : widths) {
+            for (const ShiftCase &shift : cases) {
+                Instance instance{&shift, width};
+                instance.encoding = encoding;
+                instances.push_back(instance);
+            }
+        }
+    }
+    auto at = [&](size_t e, size_t w, size_t c) -> Instance & {
+        return instances[(e * widths.size() + w) * cases.size() + c];
+    };
+    std::vector<Instance *> batch;
+    for (Instance &instance : instances) {
+        batch.push_back(&instance);
+    }
+    auto start = std::chrono::steady_clock::now();
+    run_instances(batch, jobs);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // the shifts of a case are in the type of a, so that is what an
+    // encoding is picked for
+    const int cell_width = 15;
+    std::cout << std::left << std::setw(10) << "type";
+    for (ShiftEncoding encoding : encodings) {
+        std::cout << std::setw(cell_width) << ShiftEncodingToString(encoding);
+    }
+    std::cout << "fastest" << std::endl;
+
+    std::vector<std::string> picks;
+    for (bool a_signed : {true, false}) {
+        for (size_t w = 0; w < widths.size(); w++) {
+            HalideType type{a_signed, widths[w]};
+            std::vector<double> totals(encodings.size(), 0);
+            std::vector<unsigned> unfinished(encodings.size(), 0);
+            bool any = false;
+            for (size_t c = 0; c < cases.size(); c++) {
+                if (cases[c].a_signed != a_signed) {
+                    continue;
+                }
+                any = true;
+                for (size_t e = 0; e < encodings.size(); e++) {
+                    const Instance &instance = at(e, w, c);
+                    totals[e] += instance.result.seconds;
+                    unfinished[e] += (instance.result.status == z3::unknown || !instance.error.empty());
+                }
+            }
+            if (!any) {
+                continue;
+            }
+            // fewest timeouts first, then the least time
+            size_t best = 0;
+            for (size_t e = 1; e < encodings.size(); e++) {
+                if (std::make_pair(unfinished[e], totals[e]) < std::make_pair(unfinished[best], totals[best])) {
+                    best = e;
+                }
+            }
+            std::cout << std::setw(10) << type.Name();
+            for (size_t e = 0; e < encodings.size(); e++) {
+                std::ostringstream text;
+                text << std::fixed << std::setprecision(3) << totals[e] << "s";
+                if (unfinished[e] != 0) {
+                    text << " (" << unfinished[e] << "?)";
+                }
+                std::cout << std::setw(cell_width) << text.str();
+            }
+            std::cout << ShiftEncodingToString(encodings[best]) << std::endl;
+            picks.push_back(type.Name() + "=" + ShiftEncodingToString(encodings[best]));
+        }
+    }
+    std::cout << std::right << cases.size() << " cases at " << widths.size() << " widths with "
+                << encodings.size() << " encodings [" << std::fixed << std::setprecision(3) << seconds << "s]"
+                << std::endl;
+
+    std::cout << "--shift-encoding '";
+    for (size_t p = 0; p < picks.size(); p++) {
+        std::cout << (p == 0 ? "" : ",") << picks[p];
+    }
+    std::cout << "'" << std::endl;
+
+    // every encoding means the same, a case they disagree on is a bug in one
+    for (size_t w = 0; w < widths.size(); w++) {
+        for (size_t c = 0; c < cases.size(); c++) {
+            std::string first;
+            for (size_t e = 0; e < encodings.size(); e++) {
+                std::string outcome = verdict(at(e, w, c));
+                if (outcome != "pass" && outcome != "FAIL") {
+                    continue;
+                } else if (first.empty()) {
+                    first = outcome;
+                } else if (outcome != first) {
+                    std::cout << "ERROR: encodings disagree on " << cases[c].Name() << " at " << widths[w]
+                                << " bits" << std::endl;
+                    break;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,321 @@
+#include "Sweep.h"
+#include "Report.h"
+
+#include "z3++.h"
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+namespace {
+
+// one rule at one width
+struct Instance {
+    const Rule *rule;
+    unsigned width;
+    RuleFunction function;
+    ReportTally tally;
+    std::string output;
+    std::string error;
+};
+
+// the rule instantiated at width, nullptr if it is not
+RuleFunction at_width(const Rule *rule, unsigned width) {
+    for (const auto &instance : rule->widths) {
+        if (instance.first == width) {
+            return instance.second;
+        }
+    }
+    return nullptr;
+}
+
+// anything faster is scheduling noise, not growth
+const double min_seconds = 0.05;
+
+void run_instance(Instance &instance) {
+    std::ostringstream output;
+    std::ostream *previous_output = set_rule_output(&output);
+    ReportTally *previous_tally = set_report_tally(&instance.tally);
+    try {
+        instance.function();
+    } catch (const z3::exception &e) {
+        instance.error = e.msg();
+    }
+    set_report_tally(previous_tally);
+    set_rule_output(previous_output);
+    instance.output = output.str();
+}
+
+std::string verdict(const Instance &instance) {
+    if (!instance.error.empty()) {
+        return "error";
+    } else if (instance.tally.failed != 0) {
+        return "failed";
+    } else if (instance.tally.unknown != 0) {
+        const std::string &reason = instance.tally.reason_unknown;
+        bool timeout = reason.find("timeout") != std::string::npos || reason.find("canceled") != std::string::npos;
+        return timeout ? "timeout" : "unknown";
+    }
+    return "proved";
+}
+
+std::string cell(const Instance *instance) {
+    if (instance == nullptr) {
+        return "-";
+    }
+    std::ostringstream text;
+    text << verdict(*instance) << " " << std::fixed << std::setprecision(3) << instance->tally.seconds << "s";
+    return text.str();
+}
+
+// e.g. "x12.3 from 16 to 32 bits", or nothing if the rule scales
+std::string growth(const std::vector<const Instance *> &row, const SweepOptions &options) {
+    std::ostringstream flags;
+    for (size_t w = 1; w < row.size(); w++) {
+        const Instance *narrow = row[w - 1], *wide = row[w];
+        if (narrow == nullptr || wide == nullptr || wide->width != 2 * narrow->width) {
+            continue;
+        }
+        if (verdict(*wide) == "timeout" && verdict(*narrow) != "timeout") {
+            flags << (flags.tellp() > 0 ? ", " : "") << "timeout at " << wide->width << " bits";
+            continue;
+        }
+        double factor = std::max(wide->tally.seconds, min_seconds) / std::max(narrow->tally.seconds, min_seconds);
+        if (factor > options.growth) {
+            flags << (flags.tellp() > 0 ? ", " : "") << "x" << std::fixed << std::setprecision(1) << factor
+                    << " from " << narrow->width << " to " << wide->width << " bits";
+        }
+    }
+    return flags.str();
+}
+
+} // namespace
+
+void run_sweep(const std::vector<const Rule *> &rules, unsigned jobs, const RunOptions &run_options,
+                const SweepOptions &options) {
+    if (run_options.query_timeout_ms != 0) {
+        z3::set_param("timeout", (int)run_options.query_timeout_ms);
+    }
+
+    std::vector<const Rule *> swept;
+    for (const Rule *rule : rules) {
+        if (!rule->widths.empty()) {
+            swept.push_back(rule);
+        }
+    }
+
+    // narrow widths first, so their results are in before the slow ones
+    std::vector<Instance> instances;
+    for (unsigned width : options.widths) {
+        for (const Rule *rule : swept) {
+            if (RuleFunction function = at_width(rule, width)) {
+                instances.push_back({rule, width, function});
+            }
+        }
+    }
+
+    {
+        // waits for every instance when it goes out of scope
+        ThreadPool pool(std::max(jobs, 1u));
+        for (Instance &instance : instances) {
+            pool.Submit([&instance] { run_instance(instance); });
+        }
+    }
+
+    size_t name_width = 4;
+    for (const Rule *rule : swept) {
+        name_width = std::max(name_width, rule->name.size());
+    }
+    const int cell_width = 18;
+
+    std::cout << std::left << std::setw(name_width + 2) << "rule";
+    for (size_t w = 0; w < options.widths.size(); w++) {
+        bool last = (w + 1 == options.widths.size());
+        std::cout << std::setw(last ? 0 : cell_width) << (std::to_string(options.widths[w]) + " bits");
+    }
+    std::cout << std::endl;
+
+    unsigned flagged = 0;
+    for (const Rule *rule : swept) {
+        std::vector<const Instance *> row;
+        for (unsigned width : options.widths) {
+            auto found = std::find_if(instances.begin(), instances.end(), [&](const Instance &instance) {
+                return instance.rule == rule && instance.width == width;
+            });
+            row.push_back(found == instances.end() ? nullptr : &*found);
+        }
+
+        std::cout << std::setw(name_width + 2) << rule->name;
+        std::string flags = growth(row, options);
+        for (size_t w = 0; w < row.size(); w++) {
+            bool last = (w + 1 == row.size() && flags.empty());
+            std::cout << std::setw(last ? 0 : cell_width) << cell(row[w]);
+        }
+        if (!flags.empty()) {
+            std::cout << "! " << flags;
+            flagged++;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::right << flagged << " of " << swept.size() << " rules grow faster than x"
+                << options.growth << " per doubling of the width" << std::endl;
+
+    // rule by rule, narrow to wide
+    std::vector<const Instance *> unproved;
+    for (const Instance &instance : instances) {
+        if (verdict(instance) != "proved") {
+            unproved.push_back(&instance);
+        }
+    }
+    std::stable_sort(unproved.begin(), unproved.end(), [&](const Instance *a, const Instance *b) {
+        return std::find(swept.begin(), swept.end(), a->rule) < std::find(swept.begin(), swept.end(), b->rule);
+    });
+    for (const Instance *instance : unproved) {
+        std::cout << std::endl << "== " << instance->rule->name << " at " << instance->width << " bits ==" << std::endl;
+        std::cout << instance->output;
+        if (!instance->error.empty()) {
+            std::cout << "ERROR: z3 exception in " << instance->rule->name << ": " << instance->error << std::endl;
+        }
+    }
+}
+
+namespace {
+
+// one rule going through the stages
+struct Pipeline {
+    const Rule *rule;
+    std::vector<Instance> screen, prove;
+    size_t proofs_left = 0;
+};
+
+std::string list_widths(const std::vector<Instance> &instances) {
+    std::string widths;
+    for (const Instance &instance : instances) {
+        widths += (widths.empty() ? "" : ", ") + std::to_string(instance.width);
+    }
+    return widths;
+}
+
+} // namespace
+
+void run_staged(const std::vector<const Rule *> &rules, unsigned jobs, const RunOptions &run_options,
+                const StagedOptions &options) {
+    if (run_options.query_timeout_ms != 0) {
+        z3::set_param("timeout", (int)run_options.query_timeout_ms);
+    }
+
+    // built up front, tasks keep pointers into it
+    std::vector<Pipeline> pipelines;
+    for (const Rule *rule : rules) {
+        Pipeline pipeline;
+        pipeline.rule = rule;
+        for (unsigned width : options.screen) {
+            if (RuleFunction function = at_width(rule, width)) {
+                pipeline.screen.push_back({rule, width, function});
+            }
+        }
+        for (unsigned width : options.prove) {
+            if (RuleFunction function = at_width(rule, width)) {
+                pipeline.prove.push_back({rule, width, function});
+            }
+        }
+        if (!pipeline.screen.empty() || !pipeline.prove.empty()) {
+            pipeline.proofs_left = pipeline.prove.size();
+            pipelines.push_back(std::move(pipeline));
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::mutex mutex;
+    std::condition_variable concluded;
+    size_t done = 0, refuted = 0, proved = 0, errors = 0;
+
+    // prints the rule's outcome as soon as it is known, with the time since
+    // the start of the run
+    auto conclude = [&](Pipeline &pipeline, const Instance *failure) {
+        std::lock_guard<std::mutex> lock(mutex);
+        double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::ostringstream line;
+        line << std::fixed << std::setprecision(3);
+        if (failure != nullptr) {
+            bool error = !failure->error.empty();
+            line << (error ? "error   " : "refuted ") << pipeline.rule->name << " at " << failure->width << " bits";
+            (error ? errors : refuted)++;
+        } else {
+            std::vector<const Instance *> unproved;
+            for (const Instance &instance : pipeline.prove) {
+                if (verdict(instance) != "proved") {
+                    unproved.push_back(&instance);
+                }
+            }
+            if (unproved.empty()) {
+                line << "proved  " << pipeline.rule->name << " at " << list_widths(pipeline.screen)
+                        << (pipeline.screen.empty() || pipeline.prove.empty() ? "" : ", ")
+                        << list_widths(pipeline.prove) << " bits";
+                proved++;
+            } else {
+                line << "unknown " << pipeline.rule->name << ":";
+                for (size_t u = 0; u < unproved.size(); u++) {
+                    line << (u == 0 ? " " : ", ") << verdict(*unproved[u]) << " at " << unproved[u]->width << " bits";
+                }
+            }
+        }
+        std::cout << line.str() << " [+" << std::fixed << std::setprecision(3) << elapsed << "s]" << std::endl;
+        if (failure != nullptr) {
+            std::cout << failure->output;
+            if (!failure->error.empty()) {
+                std::cout << "ERROR: z3 exception in " << pipeline.rule->name << ": " << failure->error << std::endl;
+            }
+        }
+        done++;
+        concluded.notify_all();
+    };
+
+    ThreadPool pool(std::max(jobs, 1u));
+    // Every screening task is queued before any proof, and the pool runs
+    // tasks in order, so all the cheap refutations come first.
+    for (Pipeline &pipeline : pipelines) {
+        pool.Submit([&, p = &pipeline] {
+            for (Instance &instance : p->screen) {
+                run_instance(instance);
+                std::string result = verdict(instance);
+                if (result == "failed" || result == "error") {
+                    conclude(*p, &instance);
+                    return;
+                }
+            }
+            if (p->prove.empty()) {
+                conclude(*p, nullptr);
+                return;
+            }
+            for (Instance &instance : p->prove) {
+                pool.Submit([&, p, i = &instance] {
+                    run_instance(*i);
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if (--p->proofs_left != 0) {
+                            return;
+                        }
+                    }
+                    // the last proof to finish reports for all of them
+                    for (const Instance &proof : p->prove) {
+                        std::string result = verdict(proof);
+                        if (result == "failed" || result == "error") {
+                            conclude(*p, &proof);
+                            return;
+                        }
+                    }
+                    conclude(*p, nullptr);
+                });
+            }
+        });
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    concluded.wait(lock, [&] { return done == pipelines.size(); });
+    std::cout << refuted << " refuted, " << proved << " proved, " << errors << " errors, "
+                << (pipelines.size() - refuted - proved - errors) << " unknown" << std::endl;
+}